@@ -0,0 +1,146 @@
+/**
+ * Memoising error rate model for fairness11ax --phyModel=abstract.
+ *
+ * Geometry is static and there is no fading, so a receiver sees the same
+ * few link SNRs (one per transmitter, RU width and MCS) over and over.
+ * CachedErrorRateModel quantises the SNR to SnrStepDb and memoises the chunk
+ * success rate of BaseModel (TableBasedErrorRateModel, the WifiPhyHelper
+ * default) per (mode, channel width, preamble, PPDU field, antennas, bits,
+ * quantised SNR). Interference is still tracked per band by the
+ * SpectrumWifiPhy, so OFDMA RUs keep their own SNR; the approximation is the
+ * quantisation only (half a step, 0.125 dB with the default, at most).
+ * The PSD reception and per-band integration of the SpectrumWifiPhy, which
+ * dominate the cost at large STA counts, are not bypassed: the saving is the
+ * error model lookup only and is small.
+ *
+ * Include from exactly one translation unit per program: the TypeId is
+ * registered here.
+ */
+#ifndef CACHED_ERROR_RATE_MODEL_H
+#define CACHED_ERROR_RATE_MODEL_H
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ns3
+{
+
+class CachedErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::CachedErrorRateModel")
+        .SetParent<ErrorRateModel>()
+        .SetGroupName("Wifi")
+        .AddConstructor<CachedErrorRateModel>()
+        .AddAttribute("BaseModel",
+                      "TypeId of the error rate model whose results are cached",
+                      StringValue("ns3::TableBasedErrorRateModel"),
+                      MakeStringAccessor(&CachedErrorRateModel::m_baseModel),
+                      MakeStringChecker())
+        .AddAttribute("SnrStepDb",
+                      "SNR quantisation step (dB) of the cache key",
+                      DoubleValue(0.25),
+                      MakeDoubleAccessor(&CachedErrorRateModel::m_stepDb),
+                      MakeDoubleChecker<double>(1e-3, 3.0));
+    return tid;
+  }
+
+  CachedErrorRateModel() = default;
+
+  uint64_t GetHits() const
+  {
+    return m_hits;
+  }
+
+  uint64_t GetMisses() const
+  {
+    return m_misses;
+  }
+
+private:
+  struct Key
+  {
+    uint64_t nbits;
+    int32_t snrStep;
+    uint16_t widthMhz;
+    uint16_t modeUid;
+    uint8_t preamble;
+    uint8_t field;
+    uint8_t numRxAntennas;
+
+    bool operator==(const Key& o) const
+    {
+      return nbits == o.nbits && snrStep == o.snrStep && widthMhz == o.widthMhz && modeUid == o.modeUid &&
+             preamble == o.preamble && field == o.field && numRxAntennas == o.numRxAntennas;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& k) const
+    {
+      uint64_t h = k.nbits * 0x9e3779b97f4a7c15ull;
+      h ^= (static_cast<uint64_t>(static_cast<uint32_t>(k.snrStep)) << 32) | (uint64_t(k.widthMhz) << 16) |
+           (uint64_t(k.modeUid) << 8) | (uint64_t(k.preamble) << 4) | (uint64_t(k.field) << 2) |
+           k.numRxAntennas;
+      return static_cast<size_t>(h ^ (h >> 29));
+    }
+  };
+
+  double DoGetChunkSuccessRate(WifiMode mode,
+                               const WifiTxVector& txVector,
+                               double snr,
+                               uint64_t nbits,
+                               uint8_t numRxAntennas,
+                               WifiPPDUField field,
+                               uint16_t staId) const override
+  {
+    if (!m_base)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId(m_baseModel);
+      m_base = factory.Create<ErrorRateModel>();
+    }
+
+    const double snrDb = (snr > 0.0) ? 10.0 * std::log10(snr) : -100.0;
+    const int32_t step = static_cast<int32_t>(std::lround(snrDb / m_stepDb));
+    const Key key{nbits,
+                  step,
+                  static_cast<uint16_t>(txVector.GetChannelWidth()),
+                  static_cast<uint16_t>(mode.GetUid()),
+                  static_cast<uint8_t>(txVector.GetPreambleType()),
+                  static_cast<uint8_t>(field),
+                  numRxAntennas};
+    auto it = m_cache.find(key);
+    if (it != m_cache.end())
+    {
+      m_hits++;
+      return it->second;
+    }
+    m_misses++;
+    const double snrQ = std::pow(10.0, step * m_stepDb / 10.0);
+    const double psr = m_base->GetChunkSuccessRate(mode, txVector, snrQ, nbits, numRxAntennas, field, staId);
+    m_cache.emplace(key, psr);
+    return psr;
+  }
+
+  std::string m_baseModel{"ns3::TableBasedErrorRateModel"};
+  double m_stepDb{0.25};
+  mutable Ptr<ErrorRateModel> m_base;
+  mutable std::unordered_map<Key, double, KeyHash> m_cache;
+  mutable uint64_t m_hits{0};
+  mutable uint64_t m_misses{0};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CachedErrorRateModel);
+
+} // namespace ns3
+
+#endif /* CACHED_ERROR_RATE_MODEL_H */
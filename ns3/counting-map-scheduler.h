@@ -0,0 +1,92 @@
+/**
+ * ns-3's default event scheduler (MapScheduler) with a count of the pending
+ * events, for fairness11ax --reportMemory.
+ *
+ * The ordering is MapScheduler's own, so a run with this scheduler executes
+ * exactly the same events as one with the default. The simulator gives no
+ * access to its scheduler, so the instance in use is published through
+ * GetCurrent() (one simulator per process; null between Simulator::Destroy
+ * and the next run).
+ *
+ * Include from exactly one translation unit per program: the TypeId is
+ * registered here.
+ */
+#ifndef COUNTING_MAP_SCHEDULER_H
+#define COUNTING_MAP_SCHEDULER_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ns3
+{
+
+class CountingMapScheduler : public MapScheduler
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid = TypeId("ns3::CountingMapScheduler")
+                          .SetParent<MapScheduler>()
+                          .SetGroupName("Core")
+                          .AddConstructor<CountingMapScheduler>();
+    return tid;
+  }
+
+  CountingMapScheduler()
+  {
+    s_current = this;
+  }
+
+  ~CountingMapScheduler() override
+  {
+    if (s_current == this)
+      s_current = nullptr;
+  }
+
+  static const CountingMapScheduler* GetCurrent()
+  {
+    return s_current;
+  }
+
+  // Events inserted and neither executed nor cancelled yet
+  uint64_t GetSize() const
+  {
+    return m_size;
+  }
+
+  uint64_t GetPeakSize() const
+  {
+    return m_peak;
+  }
+
+  void Insert(const Event& ev) override
+  {
+    MapScheduler::Insert(ev);
+    m_peak = std::max(m_peak, ++m_size);
+  }
+
+  Event RemoveNext() override
+  {
+    m_size--;
+    return MapScheduler::RemoveNext();
+  }
+
+  void Remove(const Event& ev) override
+  {
+    m_size--;
+    MapScheduler::Remove(ev);
+  }
+
+private:
+  static inline CountingMapScheduler* s_current = nullptr;
+  uint64_t m_size{0};
+  uint64_t m_peak{0};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CountingMapScheduler);
+
+} // namespace ns3
+
+#endif /* COUNTING_MAP_SCHEDULER_H */
@@ -0,0 +1,295 @@
+/**
+ * Fairness-aware variant of ns-3's round-robin MU scheduler, selected with
+ * fairness11ax --muScheduler=fair.
+ *
+ * RrMultiUserScheduler keeps its RU allocation and trigger logic private, so
+ * this subclass steers the two knobs it exposes, online:
+ *   - trigger cadence (AccessReqInterval): every ControlInterval the HE and
+ *     legacy per-station throughputs of the last period give the two-group
+ *     Jain index J. Below TargetJain the interval moves by Gain * (target - J)
+ *     / (1 - target) octaves (clamped to one octave per step): longer when HE
+ *     stations are ahead of legacy ones (fewer triggers), shorter when they
+ *     are behind. At or above the target it probes ProbeStep octaves shorter,
+ *     trading fairness margin for UL OFDMA efficiency. Setting the attribute
+ *     restarts the access request timer from Now(), so a new cadence is only
+ *     applied at once when it expires before the armed one; otherwise it
+ *     takes over at the armed expiry (re-arming every ControlInterval would
+ *     postpone any longer cadence forever).
+ *   - RU sizing (NStations): the number of HE stations with a non-empty BE
+ *     queue, clamped to [1, MaxStations], so that a trigger never spends RUs
+ *     on idle stations and fewer active stations get larger RUs.
+ * The scenario supplies the observations through SetObserver().
+ *
+ * Include from exactly one translation unit per program: the TypeId is
+ * registered here.
+ */
+#ifndef FAIR_RR_MULTI_USER_SCHEDULER_H
+#define FAIR_RR_MULTI_USER_SCHEDULER_H
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+class FairRrMultiUserScheduler : public RrMultiUserScheduler
+{
+public:
+  // Cumulative observations of the BSS at the time of the call
+  struct GroupState
+  {
+    uint64_t heRxBytes{0};
+    uint64_t legacyRxBytes{0};
+    uint32_t nHe{0};
+    uint32_t nLegacy{0};
+    uint32_t heBacklogged{0}; // HE stations with a non-empty BE queue
+  };
+
+  static TypeId GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::FairRrMultiUserScheduler")
+        .SetParent<RrMultiUserScheduler>()
+        .SetGroupName("Wifi")
+        .AddConstructor<FairRrMultiUserScheduler>()
+        .AddAttribute("TargetJain",
+                      "Two-group (HE vs legacy) Jain index to maintain",
+                      DoubleValue(0.95),
+                      MakeDoubleAccessor(&FairRrMultiUserScheduler::m_targetJain),
+                      MakeDoubleChecker<double>(0.5, 1.0))
+        .AddAttribute("ControlInterval",
+                      "Period of the controller",
+                      TimeValue(MilliSeconds(50)),
+                      MakeTimeAccessor(&FairRrMultiUserScheduler::m_controlInterval),
+                      MakeTimeChecker(MicroSeconds(1)))
+        .AddAttribute("MinAccessReqInterval",
+                      "Shortest trigger cadence the controller may set",
+                      TimeValue(MilliSeconds(1)),
+                      MakeTimeAccessor(&FairRrMultiUserScheduler::m_minInterval),
+                      MakeTimeChecker(MicroSeconds(1)))
+        .AddAttribute("MaxAccessReqInterval",
+                      "Longest trigger cadence the controller may set",
+                      TimeValue(MilliSeconds(100)),
+                      MakeTimeAccessor(&FairRrMultiUserScheduler::m_maxInterval),
+                      MakeTimeChecker(MicroSeconds(1)))
+        .AddAttribute("Gain",
+                      "Octaves of interval change per unit of normalised Jain error",
+                      DoubleValue(1.0),
+                      MakeDoubleAccessor(&FairRrMultiUserScheduler::m_gain),
+                      MakeDoubleChecker<double>(0.0))
+        .AddAttribute("ProbeStep",
+                      "Octaves the interval shortens per period while the target is met",
+                      DoubleValue(0.1),
+                      MakeDoubleAccessor(&FairRrMultiUserScheduler::m_probeStep),
+                      MakeDoubleChecker<double>(0.0))
+        .AddAttribute("MaxStations",
+                      "Upper bound of the RU sizing (stations per basic trigger)",
+                      UintegerValue(9),
+                      MakeUintegerAccessor(&FairRrMultiUserScheduler::m_maxStations),
+                      MakeUintegerChecker<uint8_t>(1))
+        .AddTraceSource("Control",
+                        "Controller step: access request interval, stations per trigger, measured Jain",
+                        MakeTraceSourceAccessor(&FairRrMultiUserScheduler::m_controlTrace),
+                        "ns3::FairRrMultiUserScheduler::ControlCallback");
+    return tid;
+  }
+
+  typedef void (*ControlCallback)(Time interval, uint8_t nStations, double jain);
+
+  FairRrMultiUserScheduler() = default;
+
+  void SetObserver(Callback<GroupState> observer)
+  {
+    m_observer = observer;
+  }
+
+  Time GetCurrentInterval() const
+  {
+    return Seconds(std::exp2(m_log2IntervalS));
+  }
+
+  uint8_t GetCurrentNStations() const
+  {
+    return m_nStationsSet;
+  }
+
+  uint64_t GetControlSteps() const
+  {
+    return m_steps;
+  }
+
+  /**
+   * Restart the controller and the access request timer from another
+   * cadence (0, i.e. no access requests, makes no sense for an uplink
+   * controller: the longest one), e.g. for a new sweep point of a
+   * warm-started run. Use this instead of setting AccessReqInterval, which
+   * the next control step would overwrite.
+   */
+  void ResetInterval(Time start)
+  {
+    if (!start.IsStrictlyPositive())
+      start = m_maxInterval;
+    m_log2IntervalS = std::log2(std::clamp(start, m_minInterval, m_maxInterval).GetSeconds());
+    m_intervalSet = MicroSeconds(std::llround(std::exp2(m_log2IntervalS) * 1e6));
+    CountAccessRequests();
+    m_applyEvent.Cancel();
+    ArmInterval(m_intervalSet);
+  }
+
+  // Access request timer expiries so far (the cadence actually armed, for
+  // comparison with the triggers sent)
+  uint64_t GetAccessRequests()
+  {
+    CountAccessRequests();
+    return m_accessReqs;
+  }
+
+protected:
+  void DoInitialize() override
+  {
+    RrMultiUserScheduler::DoInitialize();
+
+    // Start from the configured cadence (re-arming what the base class armed)
+    TimeValue tv;
+    GetAttribute("AccessReqInterval", tv);
+    ResetInterval(tv.Get());
+    UintegerValue nStations;
+    GetAttribute("NStations", nStations);
+    m_nStationsSet = static_cast<uint8_t>(nStations.Get());
+    m_controlEvent = Simulator::Schedule(m_controlInterval, &FairRrMultiUserScheduler::Control, this);
+  }
+
+  void DoDispose() override
+  {
+    m_controlEvent.Cancel();
+    m_applyEvent.Cancel();
+    m_observer = MakeNullCallback<GroupState>();
+    RrMultiUserScheduler::DoDispose();
+  }
+
+private:
+  // Count the expiries of the armed timer up to Now()
+  void CountAccessRequests()
+  {
+    if (!m_armedInterval.IsStrictlyPositive())
+      return;
+    while (m_nextAccessReq <= Simulator::Now())
+    {
+      m_accessReqs++;
+      m_nextAccessReq += m_armedInterval;
+    }
+  }
+
+  // The attribute setter restarts the access request timer from Now().
+  void ArmInterval(Time interval)
+  {
+    SetAttribute("AccessReqInterval", TimeValue(interval));
+    m_armedInterval = interval;
+    m_nextAccessReq = Simulator::Now() + interval;
+  }
+
+  // Make m_intervalSet the cadence without postponing the armed expiry.
+  void UpdateInterval()
+  {
+    CountAccessRequests();
+    m_applyEvent.Cancel();
+    if (m_intervalSet == m_armedInterval)
+      return;
+    if (!m_armedInterval.IsStrictlyPositive() || Simulator::Now() + m_intervalSet < m_nextAccessReq)
+    {
+      ArmInterval(m_intervalSet);
+      return;
+    }
+    // Runs after the timer event of that expiry (scheduled earlier)
+    m_applyEvent =
+      Simulator::Schedule(m_nextAccessReq - Simulator::Now(), &FairRrMultiUserScheduler::ApplyInterval, this);
+  }
+
+  void ApplyInterval()
+  {
+    CountAccessRequests();
+    ArmInterval(m_intervalSet);
+  }
+
+  void Control()
+  {
+    m_controlEvent = Simulator::Schedule(m_controlInterval, &FairRrMultiUserScheduler::Control, this);
+    if (m_observer.IsNull())
+      return;
+
+    const GroupState s = m_observer();
+    const double dHe = static_cast<double>(s.heRxBytes - m_last.heRxBytes);
+    const double dLegacy = static_cast<double>(s.legacyRxBytes - m_last.legacyRxBytes);
+    m_last = s;
+    m_steps++;
+
+    // RU sizing from the backlog
+    const uint8_t nStations =
+      static_cast<uint8_t>(std::clamp<uint32_t>(s.heBacklogged, 1, std::max<uint32_t>(1, m_maxStations)));
+    if (nStations != m_nStationsSet)
+    {
+      SetAttribute("NStations", UintegerValue(nStations));
+      m_nStationsSet = nStations;
+    }
+
+    // Trigger cadence from the fairness error
+    double jain = 1.0;
+    if (s.nHe > 0 && s.nLegacy > 0 && dHe + dLegacy > 0)
+    {
+      const double he = dHe / s.nHe;
+      const double legacy = dLegacy / s.nLegacy;
+      jain = (he + legacy) * (he + legacy) / (2.0 * (he * he + legacy * legacy));
+      double step;
+      if (jain < m_targetJain)
+      {
+        const double e = std::min(1.0, m_gain * (m_targetJain - jain) / (1.0 - m_targetJain + 1e-9));
+        step = (he > legacy) ? e : -e;
+      }
+      else
+      {
+        step = -m_probeStep;
+      }
+      m_log2IntervalS = std::clamp(m_log2IntervalS + step, std::log2(m_minInterval.GetSeconds()),
+                                   std::log2(m_maxInterval.GetSeconds()));
+    }
+
+    // Re-arming the access request timer only when the cadence really moved
+    const Time interval = MicroSeconds(std::llround(std::exp2(m_log2IntervalS) * 1e6));
+    if (interval != m_intervalSet)
+    {
+      m_intervalSet = interval;
+      UpdateInterval();
+    }
+    m_controlTrace(interval, nStations, jain);
+  }
+
+  double m_targetJain{0.95};
+  Time m_controlInterval{MilliSeconds(50)};
+  Time m_minInterval{MilliSeconds(1)};
+  Time m_maxInterval{MilliSeconds(100)};
+  double m_gain{1.0};
+  double m_probeStep{0.1};
+  uint8_t m_maxStations{9};
+
+  Callback<GroupState> m_observer;
+  GroupState m_last;
+  double m_log2IntervalS{0.0};
+  Time m_intervalSet;   // cadence chosen by the controller
+  Time m_armedInterval; // cadence the access request timer runs with
+  Time m_nextAccessReq; // next expiry of that timer
+  uint64_t m_accessReqs{0};
+  uint8_t m_nStationsSet{0};
+  uint64_t m_steps{0};
+  EventId m_controlEvent;
+  EventId m_applyEvent; // pending change of the armed cadence
+  TracedCallback<Time, uint8_t, double> m_controlTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(FairRrMultiUserScheduler);
+
+} // namespace ns3
+
+#endif /* FAIR_RR_MULTI_USER_SCHEDULER_H */
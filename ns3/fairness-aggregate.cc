@@ -0,0 +1,871 @@
+/**
+ * fairness-aggregate: single-pass reducer for fairness11ax output.
+ *
+ * Reads any mix of
+ *   - binary records (--outFormat=binary),
+ *   - CSV records    (--outFormat=csv),
+ *   - the legacy text log (STA[i] ... lines on stdout),
+ * from files or stdin, groups them by sweep point
+ * (nLegacy, mHe, mu, AP CWmin, AP CWmax) and keeps running statistics with
+ * Welford's algorithm, so thousands of points can be reduced in one pass
+ * without storing samples.
+ *
+ * For every point it reports what process.awk reports (per-STA mean/std,
+ * network throughput as the sum of per-STA means, group means and the
+ * HE-vs-legacy Jain index), plus confidence intervals over runs for the
+ * network throughput and the per-run Jain index.
+ *
+ * With a multi-BSS run (fairness11ax --nBss), every cell of a run counts as
+ * one replication of the point: STA[i] statistics are pooled over cells,
+ * and the per-run CIs are over (run, cell) pairs.
+ *
+ * Interval records (fairness11ax --intervalMs) are skipped: only final
+ * records enter the statistics.
+ *
+ * The configuration hash of each run (record v6 field, or the "Manifest:"
+ * line of the text log) is part of the point, so runs of the same (mu, CW)
+ * point under another simTime, load, traffic model, ... are never averaged
+ * together: they are reported as separate points (with a warning), each
+ * tagged with its configHash. Inputs without a hash (older records and
+ * logs) form the configHash 0 point.
+ *
+ * Latency histogram lines written by fairness11ax --histFile ("H ..." lines)
+ * may be passed as extra inputs; they are merged across runs per STA and per
+ * group, and the merged delay/jitter percentiles are reported per point.
+ *
+ * Usage:
+ *   fairness-aggregate [--format=text|csv] [--conf=0.95] [file ...]
+ * e.g. fairness-aggregate records.bin hist.txt
+ * With no file (or "-") stdin is read. The input format is detected per file.
+ *
+ * This tool has no ns-3 dependency: it builds as an ns-3 scratch program next
+ * to fairness11ax, or standalone with
+ *   g++ -O2 -std=c++17 -o fairness-aggregate fairness-aggregate.cc
+ */
+
+#include "fairness-record.h"
+#include "latency-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// ---- Statistics ----
+
+// Welford running mean/variance (no catastrophic cancellation, no var < 0 guard).
+struct RunningStat
+{
+  uint64_t n{0};
+  double mean{0.0};
+  double m2{0.0};
+
+  void Add(double x)
+  {
+    ++n;
+    const double d = x - mean;
+    mean += d / static_cast<double>(n);
+    m2 += d * (x - mean);
+  }
+
+  // Population standard deviation (what process.awk prints)
+  double PopStd() const
+  {
+    return n > 0 ? std::sqrt(m2 / static_cast<double>(n)) : 0.0;
+  }
+
+  // Sample standard deviation (used for confidence intervals)
+  double SampleStd() const
+  {
+    return n > 1 ? std::sqrt(m2 / static_cast<double>(n - 1)) : 0.0;
+  }
+};
+
+double Jain2(double x1, double x2)
+{
+  const double denom = 2.0 * (x1 * x1 + x2 * x2);
+  if (denom <= 0.0)
+    return 0.0;
+  return ((x1 + x2) * (x1 + x2)) / denom;
+}
+
+// Lower-tail standard normal quantile (Acklam's rational approximation).
+double NormalQuantile(double p)
+{
+  static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                             1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+  static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                             6.680131188771972e+01, -1.328068155288572e+01};
+  static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                             -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+  static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                             3.754408661907416e+00};
+  const double plow = 0.02425;
+  if (p < plow)
+  {
+    const double q = std::sqrt(-2.0 * std::log(p));
+    return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+           ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+  }
+  if (p > 1.0 - plow)
+  {
+    return -NormalQuantile(1.0 - p);
+  }
+  const double q = p - 0.5;
+  const double r = q * q;
+  return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+         (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// Two-sided Student-t critical value t_{1-alpha/2, df} (Hill, CACM Algorithm 396).
+double StudentTCritical(double conf, uint64_t df)
+{
+  if (df == 0)
+    return 0.0;
+  const double p = 1.0 - conf; // two-tail probability
+  const double n = static_cast<double>(df);
+  if (df == 1)
+  {
+    const double x = p * M_PI / 2.0;
+    return std::cos(x) / std::sin(x);
+  }
+  if (df == 2)
+  {
+    return std::sqrt(2.0 / (p * (2.0 - p)) - 2.0);
+  }
+  const double a = 1.0 / (n - 0.5);
+  const double b = 48.0 / (a * a);
+  double c = ((20700.0 * a / b - 98.0) * a - 16.0) * a + 96.36;
+  const double d = ((94.5 / (b + c) - 3.0) / b + 1.0) * std::sqrt(a * M_PI / 2.0) * n;
+  double x = d * p;
+  double y = std::pow(x, 2.0 / n);
+  if (y > 0.05 + a)
+  {
+    x = NormalQuantile(0.5 * p);
+    y = x * x;
+    if (df < 5)
+      c += 0.3 * (n - 4.5) * (x + 0.6);
+    c = (((0.05 * d * x - 5.0) * x - 7.0) * x - 2.0) * x + b + c;
+    y = (((((0.4 * y + 6.3) * y + 36.0) * y + 94.5) / c - y - 3.0) / b + 1.0) * x;
+    y = a * y * y;
+    y = (y > 0.002) ? std::exp(y) - 1.0 : 0.5 * y * y + y;
+  }
+  else
+  {
+    y = ((1.0 / (((n + 6.0) / (n * y) - 0.089 * d - 0.822) * (n + 2.0) * 3.0) + 0.5 / (n + 4.0)) * y -
+         1.0) *
+          (n + 1.0) / (n + 2.0) +
+        1.0 / y;
+  }
+  return std::sqrt(n * y);
+}
+
+double CiHalfWidth(const RunningStat& s, double conf)
+{
+  if (s.n < 2)
+    return 0.0;
+  return StudentTCritical(conf, s.n - 1) * s.SampleStd() / std::sqrt(static_cast<double>(s.n));
+}
+
+// ---- Sweep points ----
+
+struct PointKey
+{
+  uint32_t nLegacy;
+  uint32_t mHe;
+  int64_t muNs; // mu in integer nanoseconds, so equal intervals compare equal
+  uint32_t cwMin;
+  uint32_t cwMax;
+  uint64_t configHash; // fairness11ax run manifest; 0 if unknown
+
+  bool operator<(const PointKey& o) const
+  {
+    return std::tie(nLegacy, mHe, muNs, cwMin, cwMax, configHash) <
+           std::tie(o.nLegacy, o.mHe, o.muNs, o.cwMin, o.cwMax, o.configHash);
+  }
+
+  bool operator==(const PointKey& o) const
+  {
+    return std::tie(nLegacy, mHe, muNs, cwMin, cwMax, configHash) ==
+           std::tie(o.nLegacy, o.mHe, o.muNs, o.cwMin, o.cwMax, o.configHash);
+  }
+
+  // Same sweep point, whatever the configuration
+  bool SamePoint(const PointKey& o) const
+  {
+    return std::tie(nLegacy, mHe, muNs, cwMin, cwMax) == std::tie(o.nLegacy, o.mHe, o.muNs, o.cwMin, o.cwMax);
+  }
+};
+
+struct PointKeyHash
+{
+  size_t operator()(const PointKey& k) const
+  {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](uint64_t v) {
+      h ^= v;
+      h *= 1099511628211ULL;
+    };
+    mix(k.nLegacy);
+    mix(k.mHe);
+    mix(static_cast<uint64_t>(k.muNs));
+    mix(k.cwMin);
+    mix(k.cwMax);
+    mix(k.configHash);
+    return static_cast<size_t>(h);
+  }
+};
+
+struct StaAcc
+{
+  bool seen{false};
+  uint32_t type{fairness::STA_TYPE_LEGACY};
+  RunningStat thr;
+  RunningStat queue;
+  RunningStat fail;
+  RunningStat heSu;
+  RunningStat heTb;
+};
+
+// Per-run partial sums; a run is closed when the next run of the same point starts.
+struct OpenRun
+{
+  bool open{false};
+  uint64_t run{0};
+  uint32_t bss{0};
+  double netThr{0.0};
+  double heSum{0.0};
+  double legSum{0.0};
+  uint32_t heN{0};
+  uint32_t legN{0};
+};
+
+// Latency histograms of one STA, merged over runs
+struct StaLatency
+{
+  uint32_t type{fairness::STA_TYPE_LEGACY};
+  fairness::LatencyHistogram delay;
+  fairness::LatencyHistogram jitter;
+};
+
+struct PointState
+{
+  std::vector<StaAcc> stas;
+  OpenRun cur;
+  RunningStat runNetThr;
+  RunningStat runJain;
+  std::vector<StaLatency> latency; // only filled when histogram lines are read
+
+  void CloseRun()
+  {
+    if (!cur.open)
+      return;
+    const double he = cur.heN ? cur.heSum / cur.heN : 0.0;
+    const double leg = cur.legN ? cur.legSum / cur.legN : 0.0;
+    runNetThr.Add(cur.netThr);
+    runJain.Add(Jain2(he, leg));
+    cur = OpenRun{};
+  }
+};
+
+// Input-format independent view of one STA result
+struct Sample
+{
+  PointKey key;
+  uint64_t run;
+  uint32_t bss;
+  uint32_t sta;
+  uint32_t type;
+  double thr;
+  double queue;
+  double fail;
+  double heSu;
+  double heTb;
+};
+
+class Aggregator
+{
+public:
+  void Add(const Sample& s)
+  {
+    PointState& p = m_points[s.key];
+    if (p.cur.open && (p.cur.run != s.run || p.cur.bss != s.bss))
+    {
+      p.CloseRun();
+    }
+    if (!p.cur.open)
+    {
+      p.cur.open = true;
+      p.cur.run = s.run;
+      p.cur.bss = s.bss;
+    }
+
+    if (p.stas.size() <= s.sta)
+    {
+      p.stas.resize(s.sta + 1);
+    }
+    StaAcc& a = p.stas[s.sta];
+    a.seen = true;
+    a.type = s.type;
+    a.thr.Add(s.thr);
+    a.queue.Add(s.queue);
+    a.fail.Add(s.fail);
+    a.heSu.Add(s.heSu);
+    a.heTb.Add(s.heTb);
+
+    p.cur.netThr += s.thr;
+    if (s.type == fairness::STA_TYPE_HE)
+    {
+      p.cur.heSum += s.thr;
+      p.cur.heN++;
+    }
+    else
+    {
+      p.cur.legSum += s.thr;
+      p.cur.legN++;
+    }
+  }
+
+  // One "H" histogram line (see fairness11ax --histFile)
+  bool AddHistogram(const char* line)
+  {
+    unsigned long long run;
+    uint32_t nLegacy, mHe, cwMin, cwMax, sta, type;
+    double mu;
+    char metric[16];
+    int consumed = 0;
+    if (std::sscanf(line, "H %llu %u %u %lf %u %u %u %u %15s %n", &run, &nLegacy, &mHe, &mu, &cwMin,
+                    &cwMax, &sta, &type, metric, &consumed) != 9 ||
+        consumed == 0)
+    {
+      return false;
+    }
+    // No configHash on histogram lines: Finish() files them under their point.
+    PointState& p = m_points[PointKey{nLegacy, mHe, std::llround(mu * 1e9), cwMin, cwMax, 0}];
+    if (p.latency.size() <= sta)
+    {
+      p.latency.resize(sta + 1);
+    }
+    StaLatency& l = p.latency[sta];
+    l.type = type;
+    if (std::strcmp(metric, "delay") == 0)
+      return l.delay.MergeSerialized(line + consumed);
+    if (std::strcmp(metric, "jitter") == 0)
+      return l.jitter.MergeSerialized(line + consumed);
+    return false;
+  }
+
+  void Finish()
+  {
+    for (auto& kv : m_points)
+    {
+      kv.second.CloseRun();
+    }
+
+    // Histogram-only configHash 0 points go to the one hashed point they
+    // belong to; runs of several configurations at one point are reported.
+    std::vector<PointKey> keys;
+    for (const auto& kv : m_points)
+      keys.push_back(kv.first);
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size();)
+    {
+      size_t j = i;
+      while (j < keys.size() && keys[j].SamePoint(keys[i]))
+        ++j;
+      PointState& first = m_points[keys[i]];
+      const bool histOnly = keys[i].configHash == 0 && first.runNetThr.n == 0;
+      if (histOnly && j - i == 2)
+      {
+        m_points[keys[i + 1]].latency = std::move(first.latency);
+        m_points.erase(keys[i]);
+      }
+      else if (j - i - histOnly > 1)
+      {
+        std::fprintf(stderr,
+                     "warning: point nLegacy=%u mHe=%u mu=%.9g AP_CWMIN=%u AP_CWMAX=%u has runs of %zu "
+                     "configurations (configHash); reported separately\n",
+                     keys[i].nLegacy, keys[i].mHe, keys[i].muNs * 1e-9, keys[i].cwMin, keys[i].cwMax,
+                     j - i - histOnly);
+      }
+      i = j;
+    }
+  }
+
+  // Points in a stable (sorted) order
+  std::vector<std::pair<PointKey, const PointState*>> Sorted() const
+  {
+    std::vector<std::pair<PointKey, const PointState*>> out;
+    out.reserve(m_points.size());
+    for (const auto& kv : m_points)
+    {
+      out.emplace_back(kv.first, &kv.second);
+    }
+    std::sort(out.begin(), out.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+    return out;
+  }
+
+private:
+  std::unordered_map<PointKey, PointState, PointKeyHash> m_points;
+};
+
+// Group-level summary computed the same way as process.awk
+struct PointSummary
+{
+  double netThr{0.0};
+  double heAvg{0.0};
+  double legAvg{0.0};
+  double jain{0.0};
+};
+
+PointSummary Summarize(const PointState& p)
+{
+  PointSummary s;
+  double heSum = 0.0;
+  double legSum = 0.0;
+  uint32_t heN = 0;
+  uint32_t legN = 0;
+  for (const StaAcc& a : p.stas)
+  {
+    if (!a.seen)
+      continue;
+    s.netThr += a.thr.mean;
+    if (a.type == fairness::STA_TYPE_HE)
+    {
+      heSum += a.thr.mean;
+      heN++;
+    }
+    else
+    {
+      legSum += a.thr.mean;
+      legN++;
+    }
+  }
+  s.heAvg = heN ? heSum / heN : 0.0;
+  s.legAvg = legN ? legSum / legN : 0.0;
+  s.jain = Jain2(s.heAvg, s.legAvg);
+  return s;
+}
+
+// ---- Input parsers ----
+
+PointKey MakeKey(uint32_t nLegacy, uint32_t mHe, double muSeconds, uint32_t cwMin, uint32_t cwMax,
+                 uint64_t configHash)
+{
+  return PointKey{nLegacy, mHe, std::llround(muSeconds * 1e9), cwMin, cwMax, configHash};
+}
+
+Sample FromRecord(const fairness::StaRecord& r)
+{
+  Sample s;
+  s.key = MakeKey(r.nLegacy, r.mHe, r.mu, r.cwMin, r.cwMax, r.configHash);
+  s.run = r.run;
+  s.bss = r.bss;
+  s.sta = r.sta;
+  s.type = r.type;
+  s.thr = r.throughputMbps;
+  s.queue = r.avgMacQueue;
+  s.fail = static_cast<double>(r.collisionsLike);
+  s.heSu = static_cast<double>(r.heSuTxMpdu);
+  s.heTb = static_cast<double>(r.heTbTxMpdu);
+  return s;
+}
+
+bool ReadBinary(std::FILE* f, const std::string& name, Aggregator& agg)
+{
+  fairness::FileHeader h{};
+  if (std::fread(&h, sizeof(h), 1, f) != 1 || std::memcmp(h.magic, fairness::kRecordMagic, 8) != 0)
+  {
+    std::cerr << name << ": not a fairness record file\n";
+    return false;
+  }
+  if (h.recordSize < fairness::kRecordSizeV1)
+  {
+    std::cerr << name << ": record version " << h.version << " has unexpected size " << h.recordSize << "\n";
+    return false;
+  }
+
+  // Older files hold a prefix of the current record, newer ones a superset.
+  const size_t stride = h.recordSize;
+  const size_t copy = std::min(stride, sizeof(fairness::StaRecord));
+  std::vector<char> buf(stride * 4096);
+  size_t n;
+  while ((n = std::fread(buf.data(), stride, 4096, f)) > 0)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      fairness::StaRecord r{};
+      std::memcpy(&r, buf.data() + i * stride, copy);
+      if (r.kind == fairness::RECORD_KIND_FINAL)
+        agg.Add(FromRecord(r));
+    }
+  }
+  return true;
+}
+
+bool ParseCsvLine(const char* line, fairness::StaRecord& r)
+{
+  unsigned long long run, rxBytes, coll, finalF, drops, su, tb, suB, tbB;
+  const int n = std::sscanf(line,
+                            "%llu,%lf,%lf,%lf,%lf,%lf,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%u,%u,%u,%u,%u,%u",
+                            &run, &r.mu, &r.simTime, &r.lambda, &r.throughputMbps, &r.avgMacQueue, &rxBytes,
+                            &coll, &finalF, &drops, &su, &tb, &suB, &tbB, &r.cwMin, &r.cwMax, &r.nLegacy,
+                            &r.mHe, &r.sta, &r.type);
+  if (n != 20)
+    return false;
+  r.run = run;
+  r.rxBytes = rxBytes;
+  r.collisionsLike = coll;
+  r.finalFailures = finalF;
+  r.phyTxDrops = drops;
+  r.heSuTxMpdu = su;
+  r.heTbTxMpdu = tb;
+  r.heSuTxBytes = suB;
+  r.heTbTxBytes = tbB;
+
+  // v3/v4 columns (bss, channel, intervalEnd, kind, interval) follow the 27
+  // columns of v2; absent in older files
+  const char* p = line;
+  for (int commas = 0; p && commas < 27; ++commas)
+  {
+    p = std::strchr(p, ',');
+    if (p)
+      ++p;
+  }
+  if (p)
+    std::sscanf(p, "%u,%u,%lf,%u,%u", &r.bss, &r.channel, &r.intervalEnd, &r.kind, &r.interval);
+
+  // v6: configHash is the 39th column
+  for (int commas = 27; p && commas < 38; ++commas)
+  {
+    p = std::strchr(p, ',');
+    if (p)
+      ++p;
+  }
+  if (p)
+    r.configHash = std::strtoull(p, nullptr, 10);
+  return true;
+}
+
+// Value following "key" in a text line, or def if absent.
+double FieldAfter(const char* line, const char* key, double def = 0.0)
+{
+  const char* p = std::strstr(line, key);
+  if (!p)
+    return def;
+  return std::strtod(p + std::strlen(key), nullptr);
+}
+
+// Legacy text log state: the header lines of each "=== Results" block
+struct TextState
+{
+  uint32_t nLegacy{0};
+  uint32_t mHe{0};
+  uint32_t cwMin{0};
+  uint32_t cwMax{0};
+  double mu{0.0};
+  uint64_t run{0};
+  uint32_t bss{0};
+  uint64_t configHash{0};
+  uint64_t blocks{0};
+};
+
+void ParseTextLine(const char* line, TextState& st, Aggregator& agg)
+{
+  if (std::strncmp(line, "=== Results", 11) == 0)
+  {
+    // Logs without an RngRun line number their blocks sequentially.
+    st.run = st.blocks++;
+    st.configHash = 0;
+    return;
+  }
+  if (std::strncmp(line, "Manifest:", 9) == 0)
+  {
+    const char* h = std::strstr(line, "configHash=");
+    st.configHash = h ? std::strtoull(h + 11, nullptr, 16) : 0;
+    return;
+  }
+  if (std::strncmp(line, "nLegacy=", 8) == 0)
+  {
+    st.nLegacy = static_cast<uint32_t>(FieldAfter(line, "nLegacy="));
+    st.mHe = static_cast<uint32_t>(FieldAfter(line, "mHe="));
+    st.cwMin = static_cast<uint32_t>(FieldAfter(line, "apCWmin="));
+    st.cwMax = static_cast<uint32_t>(FieldAfter(line, "apCWmax="));
+    return;
+  }
+  if (std::strncmp(line, "RngRun=", 7) == 0)
+  {
+    st.run = static_cast<uint64_t>(FieldAfter(line, "RngRun="));
+    st.mu = FieldAfter(line, "muAccessReqInterval=", st.mu);
+    st.bss = static_cast<uint32_t>(FieldAfter(line, "bss="));
+    return;
+  }
+  if (std::strncmp(line, "H ", 2) == 0)
+  {
+    agg.AddHistogram(line);
+    return;
+  }
+  if (std::strncmp(line, "STA[", 4) != 0)
+    return;
+
+  Sample s;
+  s.key = MakeKey(st.nLegacy, st.mHe, st.mu, st.cwMin, st.cwMax, st.configHash);
+  s.run = st.run;
+  s.bss = st.bss;
+  s.sta = static_cast<uint32_t>(std::strtoul(line + 4, nullptr, 10));
+  s.type = std::strstr(line, "HE(11ax)") ? fairness::STA_TYPE_HE : fairness::STA_TYPE_LEGACY;
+  s.thr = FieldAfter(line, "throughput=");
+  s.queue = FieldAfter(line, "avgMacQueue=");
+  s.fail = FieldAfter(line, "macTxDataFailed=");
+  s.heSu = FieldAfter(line, "heSuTxMpdu=");
+  s.heTb = FieldAfter(line, "heTbTxMpdu=");
+  agg.Add(s);
+}
+
+bool ReadStream(std::FILE* f, const std::string& name, TextState& st, Aggregator& agg)
+{
+  const int c0 = std::fgetc(f);
+  if (c0 == EOF)
+    return true;
+  std::ungetc(c0, f);
+  if (c0 == fairness::kRecordMagic[0])
+  {
+    return ReadBinary(f, name, agg);
+  }
+
+  char line[4096];
+  bool csv = false;
+  bool first = true;
+  while (std::fgets(line, sizeof(line), f))
+  {
+    if (first)
+    {
+      first = false;
+      if (std::strncmp(line, "run,", 4) == 0)
+      {
+        csv = true;
+        continue;
+      }
+    }
+    if (csv)
+    {
+      fairness::StaRecord r{};
+      if (ParseCsvLine(line, r) && r.kind == fairness::RECORD_KIND_FINAL)
+      {
+        agg.Add(FromRecord(r));
+      }
+      continue;
+    }
+    ParseTextLine(line, st, agg);
+  }
+  return true;
+}
+
+// ---- Output ----
+
+const char* TypeName(uint32_t type)
+{
+  return type == fairness::STA_TYPE_HE ? "11ax" : "11ac";
+}
+
+// Per-group merged latency of one point
+struct GroupLatency
+{
+  fairness::LatencyHistogram delay[2];
+  fairness::LatencyHistogram jitter[2];
+};
+
+GroupLatency MergeGroups(const PointState& p)
+{
+  GroupLatency g;
+  for (const StaLatency& l : p.latency)
+  {
+    const uint32_t t = (l.type == fairness::STA_TYPE_HE) ? 1 : 0;
+    g.delay[t].Merge(l.delay);
+    g.jitter[t].Merge(l.jitter);
+  }
+  return g;
+}
+
+void PrintLatencyLine(const char* label, const fairness::LatencyHistogram& d, const fairness::LatencyHistogram& j)
+{
+  std::printf("%s: n=%llu p50=%.0f p95=%.0f p99=%.0f max=%llu us  jitterP50=%.0f jitterP99=%.0f us\n",
+              label, (unsigned long long)d.Count(), d.Percentile(0.50), d.Percentile(0.95), d.Percentile(0.99),
+              (unsigned long long)d.Max(), j.Percentile(0.50), j.Percentile(0.99));
+}
+
+void PrintText(const Aggregator& agg, double conf)
+{
+  const int confPct = static_cast<int>(std::lround(conf * 100.0));
+  bool firstPoint = true;
+  for (const auto& [key, p] : agg.Sorted())
+  {
+    if (!firstPoint)
+      std::printf("\n");
+    firstPoint = false;
+
+    std::printf("# point nLegacy=%u mHe=%u mu=%.9g AP_CWMIN=%u AP_CWMAX=%u runs=%llu",
+                key.nLegacy, key.mHe, key.muNs * 1e-9, key.cwMin, key.cwMax,
+                (unsigned long long)p->runNetThr.n);
+    if (key.configHash)
+      std::printf(" configHash=%016llx", (unsigned long long)key.configHash);
+    std::printf("\n");
+    std::printf("%-15s %-18s %-18s %-18s %-18s %-18s\n",
+                "STA", "throughput(avg/std)", "queue(avg/std)", "txFail(avg/std)", "heSU(avg/std)",
+                "heTB(avg/std)");
+    for (uint32_t i = 0; i < p->stas.size(); ++i)
+    {
+      const StaAcc& a = p->stas[i];
+      if (!a.seen)
+        continue;
+      std::printf("STA[%u][%s] %9.3f/%7.3f  %11.1f/%9.1f  %9.2f/%7.2f  %9.2f/%7.2f  %9.2f/%7.2f  ci%d=%.3f\n",
+                  i, TypeName(a.type),
+                  a.thr.mean, a.thr.PopStd(),
+                  a.queue.mean, a.queue.PopStd(),
+                  a.fail.mean, a.fail.PopStd(),
+                  a.heSu.mean, a.heSu.PopStd(),
+                  a.heTb.mean, a.heTb.PopStd(),
+                  confPct, CiHalfWidth(a.thr, conf));
+    }
+
+    const PointSummary s = Summarize(*p);
+    std::printf("\n");
+    std::printf("Network throughput (sum of per-STA mean) = %.6f Mbps\n", s.netThr);
+    std::printf("Group-average throughput (per-station mean): HE(11ax)=%.6f Mbps, Legacy(11ac)=%.6f Mbps\n",
+                s.heAvg, s.legAvg);
+    std::printf("Jain_group (HE vs Legacy) = %.6f\n", s.jain);
+    std::printf("CI%d network throughput = +/- %.6f Mbps (n=%llu)\n",
+                confPct, CiHalfWidth(p->runNetThr, conf), (unsigned long long)p->runNetThr.n);
+    std::printf("CI%d per-run Jain_group = %.6f +/- %.6f\n",
+                confPct, p->runJain.mean, CiHalfWidth(p->runJain, conf));
+
+    if (!p->latency.empty())
+    {
+      char label[64];
+      for (uint32_t i = 0; i < p->latency.size(); ++i)
+      {
+        const StaLatency& l = p->latency[i];
+        if (l.delay.Count() == 0)
+          continue;
+        std::snprintf(label, sizeof(label), "Uplink delay sta%u[%s]", i, TypeName(l.type));
+        PrintLatencyLine(label, l.delay, l.jitter);
+      }
+      const GroupLatency g = MergeGroups(*p);
+      PrintLatencyLine("Uplink delay HE(11ax)", g.delay[1], g.jitter[1]);
+      PrintLatencyLine("Uplink delay Legacy(11ac)", g.delay[0], g.jitter[0]);
+    }
+  }
+}
+
+void PrintCsv(const Aggregator& agg, double conf)
+{
+  std::printf("nLegacy,nHe,mu,apCwMin,apCwMax,runs,thr_total_mbps,thr_he_avg_mbps,thr_legacy_avg_mbps,"
+              "jain_group,thr_total_ci,jain_run_mean,jain_run_ci,"
+              "he_delay_p50_us,he_delay_p95_us,he_delay_p99_us,he_delay_max_us,"
+              "legacy_delay_p50_us,legacy_delay_p95_us,legacy_delay_p99_us,legacy_delay_max_us,configHash\n");
+  for (const auto& [key, p] : agg.Sorted())
+  {
+    const PointSummary s = Summarize(*p);
+    std::printf("%u,%u,%.9g,%u,%u,%llu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f",
+                key.nLegacy, key.mHe, key.muNs * 1e-9, key.cwMin, key.cwMax,
+                (unsigned long long)p->runNetThr.n, s.netThr, s.heAvg, s.legAvg, s.jain,
+                CiHalfWidth(p->runNetThr, conf), p->runJain.mean, CiHalfWidth(p->runJain, conf));
+    if (p->latency.empty())
+    {
+      std::printf(",,,,,,,,,%016llx\n", (unsigned long long)key.configHash);
+      continue;
+    }
+    const GroupLatency g = MergeGroups(*p);
+    for (int t : {1, 0})
+    {
+      const fairness::LatencyHistogram& d = g.delay[t];
+      std::printf(",%.0f,%.0f,%.0f,%llu", d.Percentile(0.50), d.Percentile(0.95), d.Percentile(0.99),
+                  (unsigned long long)d.Max());
+    }
+    std::printf(",%016llx\n", (unsigned long long)key.configHash);
+  }
+}
+
+void Usage()
+{
+  std::cerr << "usage: fairness-aggregate [--format=text|csv] [--conf=0.95] [file ...]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string format = "text";
+  double conf = 0.95;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg.rfind("--format=", 0) == 0)
+    {
+      format = arg.substr(9);
+    }
+    else if (arg.rfind("--conf=", 0) == 0)
+    {
+      conf = std::strtod(arg.c_str() + 7, nullptr);
+    }
+    else if (arg == "--help" || arg == "-h")
+    {
+      Usage();
+      return 0;
+    }
+    else if (arg.rfind("--", 0) == 0)
+    {
+      Usage();
+      return 2;
+    }
+    else
+    {
+      inputs.push_back(arg);
+    }
+  }
+  if ((format != "text" && format != "csv") || !(conf > 0.0 && conf < 1.0))
+  {
+    Usage();
+    return 2;
+  }
+  if (inputs.empty())
+  {
+    inputs.push_back("-");
+  }
+
+  Aggregator agg;
+  TextState textState; // shared so that run numbering continues across text files
+  bool ok = true;
+  for (const std::string& in : inputs)
+  {
+    std::FILE* f = (in == "-") ? stdin : std::fopen(in.c_str(), "rb");
+    if (!f)
+    {
+      std::cerr << in << ": cannot open\n";
+      ok = false;
+      continue;
+    }
+    ok = ReadStream(f, in, textState, agg) && ok;
+    if (f != stdin)
+      std::fclose(f);
+  }
+  agg.Finish();
+
+  if (format == "csv")
+    PrintCsv(agg, conf);
+  else
+    PrintText(agg, conf);
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,493 @@
+/**
+ * Fixed-schema per-STA result records written by fairness11ax
+ * (--outFormat=csv|binary, --outFile=...).
+ *
+ * One record is produced per STA per replication (plus, with --intervalMs,
+ * one RECORD_KIND_INTERVAL record per STA per period on a separate
+ * RecordStream, in the same schema). Files are opened in append
+ * mode so that a whole sweep can share one file; the schema header (CSV header
+ * line, or the binary FileHeader) is only written when the file is empty, and
+ * a non-empty file is only appended to if its header is this build's.
+ *
+ * Binary layout: FileHeader followed by back-to-back StaRecord structs in host
+ * (little-endian) byte order. Every record has the same size and field offsets,
+ * so a reader can memory-map the file and view each field as a strided column
+ * (e.g. numpy.memmap with a structured dtype) without parsing anything.
+ *
+ * Schema evolution: new versions only append fields, so an older record is a
+ * prefix of a newer one. Readers use FileHeader::recordSize as the stride and
+ * copy min(recordSize, sizeof(StaRecord)) bytes; CSV readers accept any row
+ * with at least the version-1 columns.
+ *
+ * This header has no ns-3 dependency: it is shared by the scenario and by the
+ * post-processing tools.
+ */
+#ifndef FAIRNESS_RECORD_H
+#define FAIRNESS_RECORD_H
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fairness
+{
+
+constexpr char kRecordMagic[8] = {'F', 'A', 'I', 'R', 'R', 'E', 'C', '\0'};
+constexpr uint32_t kRecordVersion = 6;
+
+enum StaType : uint32_t
+{
+  STA_TYPE_LEGACY = 0, // HT(11ac)
+  STA_TYPE_HE = 1,     // HE(11ax)
+};
+
+enum RecordKind : uint32_t
+{
+  RECORD_KIND_FINAL = 0,    // whole measured interval of a replication
+  RECORD_KIND_INTERVAL = 1, // one --intervalMs period (counters are deltas)
+};
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+};
+
+// 8-byte fields first, then 4-byte fields: no padding on any common ABI.
+struct StaRecord
+{
+  uint64_t run;           // RngRun
+  double mu;              // muAccessReqInterval (s)
+  double simTime;         // measured interval (s)
+  double lambda;          // offered load (pkt/s)
+  double throughputMbps;
+  double avgMacQueue;     // bytes
+  uint64_t rxBytes;
+  uint64_t collisionsLike;
+  uint64_t finalFailures;
+  uint64_t phyTxDrops;
+  uint64_t heSuTxMpdu;
+  uint64_t heTbTxMpdu;
+  uint64_t heSuTxBytes;
+  uint64_t heTbTxBytes;
+  uint32_t cwMin;         // AP BE CWmin
+  uint32_t cwMax;         // AP BE CWmax
+  uint32_t nLegacy;
+  uint32_t mHe;
+  uint32_t sta;           // STA index (legacy first, then HE)
+  uint32_t type;          // StaType
+
+  // v2: uplink one-way delay at the AP sink, and jitter |d_k - d_(k-1)| (us)
+  uint64_t rxPackets;
+  double delayP50Us;
+  double delayP95Us;
+  double delayP99Us;
+  double delayMaxUs;
+  double jitterP50Us;
+  double jitterP99Us;
+
+  // v3: cell of a multi-BSS run (--nBss); 0 and 36 for a single BSS
+  uint32_t bss;
+  uint32_t channel;       // 20 MHz channel number
+
+  // v4: live interval records (--intervalMs). For RECORD_KIND_INTERVAL,
+  // simTime is the interval length and counters, throughput, queue and
+  // delay fields cover that interval only; final records have interval 0.
+  double intervalEnd;     // simulation time at the end of the record's span (s)
+  uint32_t kind;          // RecordKind
+  uint32_t interval;      // 1-based interval index within the run
+
+  // v5: airtime of the STA's PPDUs by format (ms) and its entries in the
+  // AP's multi-STA BlockAcks
+  double airtimeSuMs;     // HE SU / ER SU
+  double airtimeTbMs;     // HE TB
+  double airtimeLegacyMs; // non-HE (VHT/HT/OFDM)
+  uint64_t mstaBaEntries;
+  uint64_t mstaBaAllAck;
+
+  // v6: reproducibility. RngSeed of the run and the FNV-1a hash of the
+  // canonical config string on the run's "Manifest:" line (same value for
+  // every RngRun of a point)
+  uint64_t seed;
+  uint64_t configHash;
+};
+
+static_assert(sizeof(StaRecord) == 29 * 8 + 10 * 4, "StaRecord must not contain padding");
+
+// Size of a version-1 record (everything up to and including 'type')
+constexpr uint32_t kRecordSizeV1 = 14 * 8 + 6 * 4;
+
+// CSV column order == StaRecord field order.
+constexpr const char* kCsvHeader =
+  "run,mu,simTime,lambda,throughputMbps,avgMacQueue,rxBytes,collisionsLike,finalFailures,"
+  "phyTxDrops,heSuTxMpdu,heTbTxMpdu,heSuTxBytes,heTbTxBytes,cwMin,cwMax,nLegacy,mHe,sta,type,"
+  "rxPackets,delayP50Us,delayP95Us,delayP99Us,delayMaxUs,jitterP50Us,jitterP99Us,bss,channel,"
+  "intervalEnd,kind,interval,airtimeSuMs,airtimeTbMs,airtimeLegacyMs,mstaBaEntries,mstaBaAllAck,seed,configHash";
+
+enum class RecordFormat
+{
+  NONE,
+  CSV,
+  BINARY,
+};
+
+// Schema header of a file or stream: FileHeader, or the CSV header line
+inline void EncodeHeader(std::vector<char>& out, RecordFormat format)
+{
+  if (format == RecordFormat::BINARY)
+  {
+    FileHeader h{};
+    std::memcpy(h.magic, kRecordMagic, sizeof(h.magic));
+    h.version = kRecordVersion;
+    h.recordSize = sizeof(StaRecord);
+    const char* b = reinterpret_cast<const char*>(&h);
+    out.insert(out.end(), b, b + sizeof(h));
+    return;
+  }
+  out.insert(out.end(), kCsvHeader, kCsvHeader + std::strlen(kCsvHeader));
+  out.push_back('\n');
+}
+
+// True if the file at path starts with exactly the header EncodeHeader()
+// writes, i.e. records of this build can be appended without misaligning the
+// file (a file written by an older schema has another version and size).
+inline bool FileHeaderMatches(const std::string& path, RecordFormat format)
+{
+  std::vector<char> expected;
+  EncodeHeader(expected, format);
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  std::vector<char> found(expected.size());
+  const size_t n = std::fread(found.data(), 1, found.size(), f);
+  std::fclose(f);
+  return n == expected.size() && found == expected;
+}
+
+inline void EncodeRecord(std::vector<char>& out, RecordFormat format, const StaRecord& r)
+{
+  if (format == RecordFormat::BINARY)
+  {
+    const char* b = reinterpret_cast<const char*>(&r);
+    out.insert(out.end(), b, b + sizeof(r));
+    return;
+  }
+
+  char line[1024];
+  const int n = std::snprintf(line, sizeof(line),
+                              "%llu,%.9g,%.9g,%.9g,%.9g,%.9g,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,"
+                              "%u,%u,%u,%u,%u,%u,%llu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%u,%u,%.9g,%u,%u,"
+                              "%.9g,%.9g,%.9g,%llu,%llu,%llu,%llu\n",
+                              (unsigned long long)r.run, r.mu, r.simTime, r.lambda, r.throughputMbps,
+                              r.avgMacQueue, (unsigned long long)r.rxBytes,
+                              (unsigned long long)r.collisionsLike, (unsigned long long)r.finalFailures,
+                              (unsigned long long)r.phyTxDrops, (unsigned long long)r.heSuTxMpdu,
+                              (unsigned long long)r.heTbTxMpdu, (unsigned long long)r.heSuTxBytes,
+                              (unsigned long long)r.heTbTxBytes, r.cwMin, r.cwMax, r.nLegacy, r.mHe,
+                              r.sta, r.type, (unsigned long long)r.rxPackets, r.delayP50Us, r.delayP95Us,
+                              r.delayP99Us, r.delayMaxUs, r.jitterP50Us, r.jitterP99Us, r.bss, r.channel,
+                              r.intervalEnd, r.kind, r.interval, r.airtimeSuMs, r.airtimeTbMs,
+                              r.airtimeLegacyMs, (unsigned long long)r.mstaBaEntries,
+                              (unsigned long long)r.mstaBaAllAck, (unsigned long long)r.seed,
+                              (unsigned long long)r.configHash);
+  if (n > 0)
+    out.insert(out.end(), line, line + n);
+}
+
+/**
+ * Append-only record sink. Records of one replication are buffered and
+ * written with a single call in Flush(), so concurrent writers appending to
+ * the same file interleave whole runs rather than partial lines.
+ */
+class RecordWriter
+{
+public:
+  RecordWriter() = default;
+  RecordWriter(const RecordWriter&) = delete;
+  RecordWriter& operator=(const RecordWriter&) = delete;
+
+  ~RecordWriter()
+  {
+    Close();
+  }
+
+  // Returns false if the file cannot be opened, or if it is not empty and its
+  // header is not this build's (another format or schema version).
+  bool Open(const std::string& path, RecordFormat format)
+  {
+    m_format = format;
+    m_file = std::fopen(path.c_str(), format == RecordFormat::BINARY ? "ab" : "a");
+    if (!m_file)
+      return false;
+    // Unbuffered: each Flush() reaches the O_APPEND descriptor as one write.
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+    std::fseek(m_file, 0, SEEK_END);
+    if (std::ftell(m_file) == 0)
+    {
+      std::vector<char> header;
+      EncodeHeader(header, m_format);
+      std::fwrite(header.data(), 1, header.size(), m_file);
+    }
+    else if (!FileHeaderMatches(path, m_format))
+    {
+      std::fclose(m_file);
+      m_file = nullptr;
+      return false;
+    }
+    return true;
+  }
+
+  bool IsOpen() const
+  {
+    return m_file != nullptr;
+  }
+
+  void Add(const StaRecord& r)
+  {
+    EncodeRecord(m_buf, m_format, r);
+  }
+
+  void Flush()
+  {
+    if (!m_file || m_buf.empty())
+      return;
+    std::fwrite(m_buf.data(), 1, m_buf.size(), m_file);
+    m_buf.clear();
+  }
+
+  void Close()
+  {
+    if (!m_file)
+      return;
+    Flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+
+private:
+  std::FILE* m_file{nullptr};
+  RecordFormat m_format{RecordFormat::NONE};
+  std::vector<char> m_buf;
+};
+
+/**
+ * Non-blocking record sink for live streaming (fairness11ax --intervalMs).
+ *
+ * The target is a file path (appended to; header written if empty, checked
+ * against this build's otherwise), a FIFO (header written on every (re)open;
+ * opening is retried while no reader is attached) or "udp:HOST:PORT" (each
+ * datagram carries the header and whole records, so any datagram can be
+ * decoded on its own). A write that would block never stalls the
+ * simulation: file/FIFO output is queued up to kMaxPending bytes and whole
+ * batches beyond that are dropped, datagrams that would block are dropped.
+ * GetDropped() counts the lost records.
+ */
+class RecordStream
+{
+public:
+  static constexpr size_t kMaxPending = 4 << 20;
+  static constexpr size_t kMaxDatagram = 60000;
+
+  RecordStream() = default;
+  RecordStream(const RecordStream&) = delete;
+  RecordStream& operator=(const RecordStream&) = delete;
+
+  ~RecordStream()
+  {
+    Close();
+  }
+
+  // Returns false if the target cannot be opened (or resolved).
+  bool Open(const std::string& target, RecordFormat format)
+  {
+    m_format = format;
+    m_target = target;
+    if (target.compare(0, 4, "udp:") == 0)
+    {
+      const size_t colon = target.rfind(':');
+      if (colon <= 4)
+        return false;
+      const std::string host = target.substr(4, colon - 4);
+      const std::string port = target.substr(colon + 1);
+      addrinfo hints{};
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_DGRAM;
+      addrinfo* res = nullptr;
+      if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res)
+        return false;
+      m_fd = ::socket(res->ai_family, res->ai_socktype | SOCK_NONBLOCK, res->ai_protocol);
+      const bool ok = m_fd >= 0 && ::connect(m_fd, res->ai_addr, res->ai_addrlen) == 0;
+      freeaddrinfo(res);
+      m_datagram = true;
+      EncodeHeader(m_header, m_format);
+      return ok;
+    }
+
+    struct stat st{};
+    m_fifo = (::stat(target.c_str(), &st) == 0 && S_ISFIFO(st.st_mode));
+    if (m_fifo)
+    {
+      // A reader leaving must surface as EPIPE, not kill the process.
+      std::signal(SIGPIPE, SIG_IGN);
+    }
+    return TryOpenFile() || m_fifo;
+  }
+
+  void Add(const StaRecord& r)
+  {
+    EncodeRecord(m_batch, m_format, r);
+    m_batchEnds.push_back(m_batch.size());
+  }
+
+  // Hand the records added since the last call to the target.
+  void Flush()
+  {
+    if (m_datagram)
+      SendDatagrams();
+    else
+      QueueAndWrite();
+    m_batch.clear();
+    m_batchEnds.clear();
+  }
+
+  uint64_t GetDropped() const
+  {
+    return m_dropped;
+  }
+
+  void Close()
+  {
+    if (m_fd < 0)
+      return;
+    if (!m_datagram && !m_pending.empty())
+    {
+      // Last chance, still without blocking
+      WritePending();
+    }
+    ::close(m_fd);
+    m_fd = -1;
+  }
+
+private:
+  bool TryOpenFile()
+  {
+    m_fd = ::open(m_target.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_NONBLOCK | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+      return false;
+    struct stat st{};
+    if (m_fifo || (::fstat(m_fd, &st) == 0 && st.st_size == 0))
+    {
+      m_pending.clear();
+      EncodeHeader(m_pending, m_format);
+    }
+    else if (!FileHeaderMatches(m_target, m_format))
+    {
+      ::close(m_fd);
+      m_fd = -1;
+      return false;
+    }
+    return true;
+  }
+
+  void QueueAndWrite()
+  {
+    if (m_fd < 0 && !(m_fifo && TryOpenFile()))
+    {
+      m_dropped += m_batchEnds.size();
+      return;
+    }
+    if (m_pending.size() + m_batch.size() > kMaxPending)
+    {
+      m_dropped += m_batchEnds.size();
+    }
+    else
+    {
+      m_pending.insert(m_pending.end(), m_batch.begin(), m_batch.end());
+    }
+    WritePending();
+  }
+
+  void WritePending()
+  {
+    size_t done = 0;
+    while (done < m_pending.size())
+    {
+      const ssize_t n = ::write(m_fd, m_pending.data() + done, m_pending.size() - done);
+      if (n > 0)
+      {
+        done += static_cast<size_t>(n);
+        continue;
+      }
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0 && errno == EPIPE && m_fifo)
+      {
+        // Reader went away: reopen (and resend the header) once one is back.
+        ::close(m_fd);
+        m_fd = -1;
+        m_pending.clear();
+        return;
+      }
+      break; // EAGAIN or a hard error: keep the rest for the next Flush()
+    }
+    m_pending.erase(m_pending.begin(), m_pending.begin() + done);
+  }
+
+  void SendDatagrams()
+  {
+    if (m_fd < 0)
+    {
+      m_dropped += m_batchEnds.size();
+      return;
+    }
+    size_t begin = 0;
+    size_t first = 0;
+    std::vector<char> dgram;
+    while (first < m_batchEnds.size())
+    {
+      // As many whole records as fit (at least one)
+      size_t last = first;
+      while (last + 1 < m_batchEnds.size() &&
+             m_header.size() + m_batchEnds[last + 1] - begin <= kMaxDatagram)
+      {
+        ++last;
+      }
+      const size_t end = m_batchEnds[last];
+      dgram.assign(m_header.begin(), m_header.end());
+      dgram.insert(dgram.end(), m_batch.begin() + begin, m_batch.begin() + end);
+      if (::send(m_fd, dgram.data(), dgram.size(), MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+      {
+        m_dropped += last - first + 1;
+      }
+      begin = end;
+      first = last + 1;
+    }
+  }
+
+  RecordFormat m_format{RecordFormat::CSV};
+  std::string m_target;
+  int m_fd{-1};
+  bool m_datagram{false};
+  bool m_fifo{false};
+  std::vector<char> m_header;
+  std::vector<char> m_batch;
+  std::vector<size_t> m_batchEnds;
+  std::vector<char> m_pending;
+  uint64_t m_dropped{0};
+};
+
+} // namespace fairness
+
+#endif /* FAIRNESS_RECORD_H */
@@ -4,204 +4,914 @@
 #include "ns3/mobility-module.h"
 #include "ns3/wifi-module.h"
 #include "ns3/spectrum-module.h"
+#include "ns3/propagation-module.h"
 #include "ns3/applications-module.h"
-
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include "cached-error-rate-model.h"
+#include "counting-map-scheduler.h"
+#include "fair-rr-multi-user-scheduler.h"
+#include "fairness-record.h"
+#include "latency-histogram.h"
+#include "scenario-file.h"
+#include "ul-ofdma-model.h"
+#include "ul-trace.h"
+#include "ul-traffic-apps.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("MixedUlNax");
 
+// ---- Utilities ----
+
+static std::vector<double> ParseCsvDoubles(const std::string& s)
+{
+  std::vector<double> out;
+  if (s.empty())
+    return out;
+
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    if (!item.empty())
+      out.push_back(std::stod(item));
+  }
+  return out;
+}
+
+// ---- Callback profiling (--profileCallbacks) ----
+
+// Groups of the scenario's own callbacks, timed separately
+enum CallbackGroup : uint32_t
+{
+  CB_QUEUE,    // BE queue traces, 1 ms queue sampler
+  CB_FAILURES, // remote station manager failures, PhyTxDrop
+  CB_TB,       // MonitorSnifferTx (HE SU/TB)
+  CB_AIRTIME,  // STA PhyTxPsduBegin
+  CB_AP,       // AP PhyTxPsduBegin, Assoc
+  CB_LATENCY,  // sink Rx callback
+  CB_TRAFFIC,  // saturated-traffic queue refill
+  CB_CONTROL,  // warm-up detection, interval reports, CW controller, fair MU observer
+  CB_ULTRACE,  // AP PHY traces of the uplink event capture (--ulTrace)
+  CB_COUNT,
+};
+
+static const char* const kCallbackGroupNames[CB_COUNT] = {"queue",   "failures", "tb",      "airtime", "ap",
+                                                          "latency", "traffic",  "control", "ultrace"};
+
+// Process-wide: trace callbacks are free functions without a context
+struct CallbackProfile
+{
+  bool enabled{false};
+  std::array<uint64_t, CB_COUNT> ns{};
+  std::array<uint64_t, CB_COUNT> calls{};
+};
+
+static CallbackProfile g_callbackProfile;
+
 /**
- * Simple Poisson UDP uplink generator:
- * inter-arrival ~ Exp(lambda), constant packet size, sends to AP:port
+ * Adds the wall time of the enclosing scope to a callback group when
+ * profiling is on; costs one predictable branch otherwise. Timed scopes do
+ * not nest (inner callees are not timed separately).
  */
-class PoissonUdpApp : public Application
+class CallbackTimer
 {
 public:
-  PoissonUdpApp() = default;
+  explicit CallbackTimer(CallbackGroup group)
+    : m_group(group)
+  {
+    if (g_callbackProfile.enabled)
+      m_start = std::chrono::steady_clock::now();
+  }
 
-  void Setup(Ptr<Socket> socket,
-             Address peer,
-             uint32_t pktSize,
-             double lambdaPktsPerSec,
-             uint64_t maxPackets = 0 /*0 => unlimited*/)
+  ~CallbackTimer()
   {
-    m_socket = socket;
-    m_peer = peer;
-    m_pktSize = pktSize;
-    m_lambda = lambdaPktsPerSec;
-    m_maxPackets = maxPackets;
-    m_sent = 0;
-    m_running = false;
-    m_rng = CreateObject<ExponentialRandomVariable>();
-    if (m_lambda > 0.0)
-    {
-      m_rng->SetAttribute("Mean", DoubleValue(1.0 / m_lambda));
-    }
+    if (!g_callbackProfile.enabled)
+      return;
+    g_callbackProfile.ns[m_group] += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+    g_callbackProfile.calls[m_group]++;
   }
 
 private:
-  void StartApplication() override
+  CallbackGroup m_group;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * Metric groups. Sink throughput per STA is always collected; every other
+ * group costs trace callbacks on the hot path and can be left out at run
+ * time (--metrics) or at compile time: build with e.g.
+ * -DFAIRNESS_METRICS=METRIC_QUEUE to compile the counters of the other
+ * groups away (they then read as 0).
+ */
+enum MetricFlags : uint32_t
+{
+  METRIC_QUEUE = 1u << 0,    // avgMacQueue (BE queue traces or 1 ms sampler)
+  METRIC_FAILURES = 1u << 1, // MacTxDataFailed, MacTxFinalDataFailed, PhyTxDrop
+  METRIC_TB = 1u << 2,       // HE SU/TB MPDUs and bytes (MonitorSnifferTx)
+  METRIC_AIRTIME = 1u << 3,  // per-STA PPDU airtime (STA PhyTxPsduBegin)
+  METRIC_AP = 1u << 4,       // AP triggers and multi-STA BlockAcks (AP PhyTxPsduBegin, Assoc)
+  METRIC_LATENCY = 1u << 5,  // delay/jitter histograms (sink Rx callback)
+  METRIC_ALL = (1u << 6) - 1,
+};
+
+#ifndef FAIRNESS_METRICS
+#define FAIRNESS_METRICS METRIC_ALL
+#endif
+
+static constexpr uint32_t kCompiledMetrics = FAIRNESS_METRICS;
+
+/**
+ * Stand-in for the counter array of a metric group compiled out: no
+ * storage, reads as 0. Writes land in a scratch word; they are never
+ * reached, since the traces that would make them are not connected.
+ */
+struct NullCounter
+{
+  void assign(size_t, uint64_t) {}
+  size_t size() const { return 0; }
+  uint64_t operator[](size_t) const { return 0; }
+  uint64_t& operator[](size_t)
   {
-    m_running = true;
-    m_socket->Bind();
-    m_socket->Connect(m_peer);
-    ScheduleNext();
+    static uint64_t scratch;
+    scratch = 0;
+    return scratch;
   }
+};
+
+template <uint32_t Metric>
+using MetricCounter =
+  std::conditional_t<(kCompiledMetrics & Metric) != 0, std::vector<uint64_t>, NullCounter>;
 
-  void StopApplication() override
+// --metrics: "all" or a comma-separated list of throughput (implied),
+// queue, failures, tb, airtime, ap, latency. Returns false on an unknown name.
+static bool ParseMetrics(const std::string& s, uint32_t* mask)
+{
+  static const std::pair<const char*, uint32_t> kNames[] = {
+    {"throughput", 0}, {"queue", METRIC_QUEUE}, {"failures", METRIC_FAILURES}, {"tb", METRIC_TB},
+    {"airtime", METRIC_AIRTIME}, {"ap", METRIC_AP}, {"latency", METRIC_LATENCY}, {"all", METRIC_ALL}};
+  *mask = 0;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
   {
-    m_running = false;
-    if (m_sendEvent.IsPending())
+    if (item.empty())
+      continue;
+    bool known = false;
+    for (const auto& [name, bits] : kNames)
     {
-      Simulator::Cancel(m_sendEvent);
+      if (item == name)
+      {
+        *mask |= bits;
+        known = true;
+      }
     }
-    if (m_socket)
+    if (!known)
+      return false;
+  }
+  return true;
+}
+
+// AcIndex order (BE, BK, VI, VO): names, WifiMac Txop attributes and the
+// user priority (TID) a socket sets to reach each AC
+static constexpr uint32_t kNumAcs = 4;
+static const char* const kAcNames[kNumAcs] = {"BE", "BK", "VI", "VO"};
+static const char* const kAcTxopAttribute[kNumAcs] = {"BE_Txop", "BK_Txop", "VI_Txop", "VO_Txop"};
+static const uint8_t kAcPriority[kNumAcs] = {0, 1, 5, 6};
+
+// --flows: one extra uplink flow on every STA of a set, next to its default
+// BE flow
+struct FlowSpec
+{
+  enum Who
+  {
+    ALL,
+    LEGACY,
+    HE,
+    RANGE, // STA indices [first, last]
+  };
+
+  Who who{ALL};
+  uint32_t first{0};
+  uint32_t last{0};
+  uint8_t ac{AC_BE};
+  uint32_t minSize{0}; // bytes, uniform in [minSize, maxSize]
+  uint32_t maxSize{0};
+  double lambda{0.0}; // pkts/s while ON
+  Time meanOn;        // zero: always ON
+  Time meanOff;
+
+  bool Covers(uint32_t sta, uint32_t nLegacy) const
+  {
+    switch (who)
     {
-      m_socket->Close();
+    case ALL:
+      return true;
+    case LEGACY:
+      return sta < nLegacy;
+    case HE:
+      return sta >= nLegacy;
+    default:
+      return sta >= first && sta <= last;
     }
   }
+};
 
-  void SendOnce()
+// --flows: comma-separated who:ac:size:lambda[:onMs:offMs], with who = all,
+// legacy, he, a STA index or an index range i-j, ac = be, bk, vi or vo, and
+// size a byte count or a range min-max. Returns false with the offending
+// entry in *bad on a syntax error.
+static bool ParseFlows(const std::string& s, std::vector<FlowSpec>* flows, std::string* bad)
+{
+  flows->clear();
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
   {
-    if (!m_running)
-      return;
+    if (item.empty())
+      continue;
+    *bad = item;
+    std::vector<std::string> f;
+    std::stringstream fs(item);
+    std::string part;
+    while (std::getline(fs, part, ':'))
+      f.push_back(part);
+    if (f.size() != 4 && f.size() != 6)
+      return false;
+
+    FlowSpec flow;
+    unsigned a = 0;
+    unsigned b = 0;
+    char tail = 0;
+    if (f[0] == "all")
+      flow.who = FlowSpec::ALL;
+    else if (f[0] == "legacy")
+      flow.who = FlowSpec::LEGACY;
+    else if (f[0] == "he")
+      flow.who = FlowSpec::HE;
+    else if (std::sscanf(f[0].c_str(), "%u-%u%c", &a, &b, &tail) == 2 && a <= b)
+      flow = FlowSpec{FlowSpec::RANGE, a, b};
+    else if (std::sscanf(f[0].c_str(), "%u%c", &a, &tail) == 1)
+      flow = FlowSpec{FlowSpec::RANGE, a, a};
+    else
+      return false;
 
-    if (m_maxPackets != 0 && m_sent >= m_maxPackets)
-      return;
+    static const char* const kAcOptions[kNumAcs] = {"be", "bk", "vi", "vo"};
+    const auto acIt = std::find(std::begin(kAcOptions), std::end(kAcOptions), f[1]);
+    if (acIt == std::end(kAcOptions))
+      return false;
+    flow.ac = static_cast<uint8_t>(acIt - std::begin(kAcOptions));
+
+    if (std::sscanf(f[2].c_str(), "%u-%u%c", &a, &b, &tail) == 2 && a > 0 && a <= b)
+    {
+      flow.minSize = a;
+      flow.maxSize = b;
+    }
+    else if (std::sscanf(f[2].c_str(), "%u%c", &a, &tail) == 1 && a > 0)
+    {
+      flow.minSize = flow.maxSize = a;
+    }
+    else
+    {
+      return false;
+    }
+
+    char* end = nullptr;
+    flow.lambda = std::strtod(f[3].c_str(), &end);
+    if (*end != '\0' || !(flow.lambda > 0.0))
+      return false;
+    if (f.size() == 6)
+    {
+      const double onMs = std::strtod(f[4].c_str(), &end);
+      if (*end != '\0' || !(onMs > 0.0))
+        return false;
+      const double offMs = std::strtod(f[5].c_str(), &end);
+      if (*end != '\0' || !(offMs > 0.0))
+        return false;
+      flow.meanOn = MicroSeconds(std::llround(onMs * 1e3));
+      flow.meanOff = MicroSeconds(std::llround(offMs * 1e3));
+    }
+    flows->push_back(flow);
+  }
+  return true;
+}
 
-    Ptr<Packet> p = Create<Packet>(m_pktSize);
-    m_socket->Send(p);
-    m_sent++;
+/**
+ * Per-station counters, one flat array per counter indexed by STA
+ * (structure of arrays): a trace callback touches a single element and the
+ * report walks each array linearly, which keeps hundreds of STAs cheap.
+ */
+struct StaCounters
+{
+  MetricCounter<METRIC_FAILURES> collisionsLike;
+  MetricCounter<METRIC_FAILURES> finalFailures;
+  MetricCounter<METRIC_FAILURES> phyTxDrops;
+  MetricCounter<METRIC_QUEUE> qBytesSum;
+  MetricCounter<METRIC_QUEUE> qSamples;
+
+  // Time-weighted BE queue occupancy (--queueSampling=trace); only
+  // integrated while queueTraced (the queue traces are connected)
+  bool queueTraced{false};
+  std::vector<double> qByteSeconds;
+  std::vector<uint32_t> qLastBytes;
+  std::vector<Time> qLastChange;
 
-    ScheduleNext();
+  // HE uplink mode counters (counts MPDUs observed on PHY TX)
+  MetricCounter<METRIC_TB> heSuTxMpdu;
+  MetricCounter<METRIC_TB> heTbTxMpdu;
+  MetricCounter<METRIC_TB> heSuTxBytes;
+  MetricCounter<METRIC_TB> heTbTxBytes;
+
+  // Airtime of the STA's own PPDUs (ns), from the TX vector and PSDU sizes:
+  // HE SU (incl. ER SU), HE TB, and non-HE (VHT/HT/OFDM, i.e. legacy STAs)
+  MetricCounter<METRIC_AIRTIME> airtimeSuNs;
+  MetricCounter<METRIC_AIRTIME> airtimeTbNs;
+  MetricCounter<METRIC_AIRTIME> airtimeLegacyNs;
+
+  // Entries for this STA in multi-STA BlockAcks sent by the AP (all-ack
+  // entries acknowledge the whole PSDU, the others carry a bitmap)
+  MetricCounter<METRIC_AP> mstaBaEntries;
+  MetricCounter<METRIC_AP> mstaBaAllAck;
+
+  void Reset(uint32_t n)
+  {
+    auto zero = [n](auto&... v) { (v.assign(n, 0), ...); };
+    zero(collisionsLike, finalFailures, phyTxDrops, qBytesSum, qSamples, heSuTxMpdu, heTbTxMpdu, heSuTxBytes,
+         heTbTxBytes, airtimeSuNs, airtimeTbNs, airtimeLegacyNs, mstaBaEntries, mstaBaAllAck);
+    qByteSeconds.assign(n, 0.0);
+    qLastBytes.assign(n, 0);
+    qLastChange.assign(n, Seconds(0));
   }
 
-  void ScheduleNext()
+  // Counters accumulated since base was copied from this object
+  void Subtract(const StaCounters& base)
   {
-    if (!m_running)
-      return;
+    auto sub = [](auto& v, const auto& b) {
+      for (size_t i = 0; i < v.size(); ++i)
+        v[i] -= b[i];
+    };
+    sub(collisionsLike, base.collisionsLike);
+    sub(finalFailures, base.finalFailures);
+    sub(phyTxDrops, base.phyTxDrops);
+    sub(qBytesSum, base.qBytesSum);
+    sub(qSamples, base.qSamples);
+    sub(heSuTxMpdu, base.heSuTxMpdu);
+    sub(heTbTxMpdu, base.heTbTxMpdu);
+    sub(heSuTxBytes, base.heSuTxBytes);
+    sub(heTbTxBytes, base.heTbTxBytes);
+    sub(airtimeSuNs, base.airtimeSuNs);
+    sub(airtimeTbNs, base.airtimeTbNs);
+    sub(airtimeLegacyNs, base.airtimeLegacyNs);
+    sub(mstaBaEntries, base.mstaBaEntries);
+    sub(mstaBaAllAck, base.mstaBaAllAck);
+    for (size_t i = 0; i < qByteSeconds.size(); ++i)
+      qByteSeconds[i] -= base.qByteSeconds[i];
+  }
+};
 
-    if (m_lambda <= 0.0)
-      return;
+/**
+ * AP-side MAC counters: trigger frames and multi-STA BlockAcks sent by the
+ * AP (PhyTxPsduBegin of the AP PHY). All fixed-size; aidToSta maps an AID
+ * (filled at association) to the STA index.
+ */
+struct ApCounters
+{
+  static constexpr uint32_t kMaxRuBins = 16; // triggersByNRu[k]: k user infos (last bin: >=)
+  static constexpr uint16_t kNoSta = 0xffff;
 
-    const double dt = m_rng->GetValue(); // seconds
-    m_sendEvent = Simulator::Schedule(Seconds(dt), &PoissonUdpApp::SendOnce, this);
+  uint64_t basicTriggers{0};
+  uint64_t bsrpTriggers{0};
+  uint64_t muBarTriggers{0};
+  uint64_t otherTriggers{0};
+  uint64_t rusAllocated{0}; // user info fields over all basic triggers
+  std::array<uint64_t, kMaxRuBins> triggersByNRu{};
+
+  uint64_t multiStaBa{0};
+  uint64_t multiStaBaEntries{0};
+  uint64_t multiStaBaAllAck{0};
+  uint64_t multiStaBaUnknownAid{0};
+  uint64_t otherBa{0}; // compressed/basic BlockAcks (SU)
+
+  std::array<uint16_t, 2048> aidToSta;
+
+  ApCounters()
+  {
+    aidToSta.fill(kNoSta);
   }
 
-private:
-  Ptr<Socket> m_socket;
-  Address m_peer;
-  uint32_t m_pktSize{1200};
-  double m_lambda{100.0};
-  uint64_t m_maxPackets{0};
-  uint64_t m_sent{0};
-  bool m_running{false};
-  EventId m_sendEvent;
-  Ptr<ExponentialRandomVariable> m_rng;
+  void Subtract(const ApCounters& b)
+  {
+    basicTriggers -= b.basicTriggers;
+    bsrpTriggers -= b.bsrpTriggers;
+    muBarTriggers -= b.muBarTriggers;
+    otherTriggers -= b.otherTriggers;
+    rusAllocated -= b.rusAllocated;
+    for (uint32_t k = 0; k < kMaxRuBins; ++k)
+      triggersByNRu[k] -= b.triggersByNRu[k];
+    multiStaBa -= b.multiStaBa;
+    multiStaBaEntries -= b.multiStaBaEntries;
+    multiStaBaAllAck -= b.multiStaBaAllAck;
+    multiStaBaUnknownAid -= b.multiStaBaUnknownAid;
+    otherBa -= b.otherBa;
+  }
 };
 
-// ---- Utilities ----
+// --ulTrace: AP-side uplink event capture of one cell (see ul-trace.h)
+struct UlTraceState
+{
+  fairness::UlTraceWriter* writer{nullptr};
+  const ApCounters* ap{nullptr}; // AID -> STA
+  uint32_t run{0};
+  uint16_t bss{0};
+  uint64_t configHash{0}; // of the point being measured (warm-start: the base cfg's until then)
+  uint32_t trigger{0};    // basic triggers sent so far
+  std::unordered_map<uint64_t, uint16_t> staByAddress;
+  // Per STA: its ALLOC event of the latest basic trigger it was in (labels
+  // the MPDUs the PHY drops, whose RU and MCS it does not report)
+  std::vector<fairness::UlTraceEvent> alloc;
+};
 
-static std::vector<double> ParseCsvDoubles(const std::string& s)
+// Per-station uplink latency, recorded at the AP sink
+struct StaLatency
 {
-  std::vector<double> out;
-  if (s.empty())
-    return out;
+  fairness::LatencyHistogram delayUs;  // one-way delay (app send -> sink Rx)
+  fairness::LatencyHistogram jitterUs; // |d_k - d_(k-1)| between consecutive packets
+  int64_t lastDelayUs{-1};
 
-  std::stringstream ss(s);
-  std::string item;
-  while (std::getline(ss, item, ','))
+  // Current --intervalMs period only (reset by every interval report)
+  fairness::LatencyHistogram intervalDelayUs;
+  fairness::LatencyHistogram intervalJitterUs;
+};
+
+/**
+ * --flows: per-AC counters, one flat array per counter indexed
+ * [ac * nSta + sta] (same layout as StaCounters, one block per AC), plus
+ * uplink delay histograms per AC and STA group. Empty (nSta = 0) without
+ * extra flows. BE also carries every STA's default flow.
+ */
+struct AcCounters
+{
+  uint32_t nSta{0};
+  uint32_t nLegacy{0};
+  std::vector<uint32_t> flows; // extra flows
+  std::vector<uint64_t> rxBytes;
+  std::vector<uint64_t> rxPackets;
+  std::vector<double> qByteSeconds; // time-weighted queue bytes
+  std::vector<uint32_t> qLastBytes;
+  std::vector<Time> qLastChange;
+  std::vector<Ptr<WifiMacQueue>> queues;                       // null: not traced
+  std::array<fairness::LatencyHistogram, kNumAcs * 2> delayUs; // [ac * 2 + (HE ? 1 : 0)]
+
+  void Reset(uint32_t n, uint32_t legacy)
   {
-    if (!item.empty())
-      out.push_back(std::stod(item));
+    nSta = n;
+    nLegacy = legacy;
+    flows.assign(kNumAcs * n, 0);
+    rxBytes.assign(kNumAcs * n, 0);
+    rxPackets.assign(kNumAcs * n, 0);
+    qByteSeconds.assign(kNumAcs * n, 0.0);
+    qLastBytes.assign(kNumAcs * n, 0);
+    qLastChange.assign(kNumAcs * n, Seconds(0));
+    queues.assign(kNumAcs * n, nullptr);
+    for (fairness::LatencyHistogram& h : delayUs)
+      h.Reset();
   }
-  return out;
-}
 
-// Per-station counters
-struct StaStats
-{
-  uint64_t collisionsLike{0};
-  uint64_t finalFailures{0};
-  uint64_t phyTxDrops{0};
-  uint64_t qBytesSum{0};
-  uint64_t qSamples{0};
+  // Closes the constant-occupancy segment of queue k up to now
+  void AccumulateQueue(uint32_t k, Time now)
+  {
+    qByteSeconds[k] += qLastBytes[k] * (now - qLastChange[k]).GetSeconds();
+    qLastChange[k] = now;
+    qLastBytes[k] = queues[k] ? queues[k]->GetNBytes() : 0;
+  }
 
-  // HE uplink mode counters (counts MPDUs observed on PHY TX)
-  uint64_t heSuTxMpdu{0};
-  uint64_t heTbTxMpdu{0};
-  uint64_t heSuTxBytes{0};
-  uint64_t heTbTxBytes{0};
+  // Start of the measurement window: drop everything counted so far
+  void Rebase(Time now)
+  {
+    for (uint32_t k = 0; k < queues.size(); ++k)
+    {
+      if (queues[k])
+        AccumulateQueue(k, now);
+    }
+    std::fill(rxBytes.begin(), rxBytes.end(), 0);
+    std::fill(rxPackets.begin(), rxPackets.end(), 0);
+    std::fill(qByteSeconds.begin(), qByteSeconds.end(), 0.0);
+    for (fairness::LatencyHistogram& h : delayUs)
+      h.Reset();
+  }
 };
 
 // Forward declarations (must appear before main)
 static void OnMacTxDataFailed(uint32_t staIndex,
-                             std::vector<StaStats>* stats,
+                             StaCounters* stats,
                              ns3::Mac48Address addr);
 
 static void OnMacTxFinalDataFailed(uint32_t staIndex,
-                                  std::vector<StaStats>* stats,
+                                  StaCounters* stats,
                                   ns3::Mac48Address addr);
 
 static void OnPhyTxDrop(uint32_t staIndex,
-                        std::vector<StaStats>* stats,
+                        StaCounters* stats,
                         ns3::Ptr<const ns3::Packet> p);
 
 
 static void OnMacTxDataFailed(uint32_t staIndex,
-                             std::vector<StaStats>* stats,
+                             StaCounters* stats,
                              ns3::Mac48Address /*addr*/)
 {
-  (*stats)[staIndex].collisionsLike++;
+  const CallbackTimer timer(CB_FAILURES);
+  stats->collisionsLike[staIndex]++;
 }
 
 static void OnMacTxFinalDataFailed(uint32_t staIndex,
-                                  std::vector<StaStats>* stats,
+                                  StaCounters* stats,
                                   ns3::Mac48Address /*addr*/)
 {
-  (*stats)[staIndex].finalFailures++;
+  const CallbackTimer timer(CB_FAILURES);
+  stats->finalFailures[staIndex]++;
 }
 
 static void OnPhyTxDrop(uint32_t staIndex,
-                        std::vector<StaStats>* stats,
+                        StaCounters* stats,
                         ns3::Ptr<const ns3::Packet> /*p*/)
 {
-  (*stats)[staIndex].phyTxDrops++;
+  const CallbackTimer timer(CB_FAILURES);
+  stats->phyTxDrops[staIndex]++;
 }
 
 static void
 OnHePhyTxMonitor(uint32_t staIndex,
-                 std::vector<StaStats>* stats,
+                 StaCounters* stats,
                  ns3::Ptr<const ns3::Packet> p,
                  uint16_t /*channelFreqMhz*/,
                  ns3::WifiTxVector txVector,
                  ns3::MpduInfo /*mpduInfo*/,
                  uint16_t /*something_uint16*/)   // <-- THIS must be uint16_t in your build
 {
+  const CallbackTimer timer(CB_TB);
   const uint32_t bytes = p ? p->GetSize() : 0;
   const auto pre = txVector.GetPreambleType();
 
   if (pre == WIFI_PREAMBLE_HE_TB)
   {
-    (*stats)[staIndex].heTbTxMpdu++;
-    (*stats)[staIndex].heTbTxBytes += bytes;
+    stats->heTbTxMpdu[staIndex]++;
+    stats->heTbTxBytes[staIndex] += bytes;
   }
   else if (pre == WIFI_PREAMBLE_HE_SU)
   {
-    (*stats)[staIndex].heSuTxMpdu++;
-    (*stats)[staIndex].heSuTxBytes += bytes;
+    stats->heSuTxMpdu[staIndex]++;
+    stats->heSuTxBytes[staIndex] += bytes;
+  }
+}
+// PPDU airtime of a STA, by PPDU format
+static void OnStaPhyTxPsduBegin(uint32_t staIndex,
+                                StaCounters* stats,
+                                WifiConstPsduMap psdus,
+                                WifiTxVector txVector,
+                                double /*txPowerW*/)
+{
+  const CallbackTimer timer(CB_AIRTIME);
+  const uint64_t ns =
+    static_cast<uint64_t>(WifiPhy::CalculateTxDuration(psdus, txVector, WIFI_PHY_BAND_5GHZ).GetNanoSeconds());
+  switch (txVector.GetPreambleType())
+  {
+  case WIFI_PREAMBLE_HE_TB:
+    stats->airtimeTbNs[staIndex] += ns;
+    break;
+  case WIFI_PREAMBLE_HE_SU:
+  case WIFI_PREAMBLE_HE_ER_SU:
+    stats->airtimeSuNs[staIndex] += ns;
+    break;
+  default:
+    stats->airtimeLegacyNs[staIndex] += ns;
+    break;
+  }
+}
+
+// Trigger frames and BlockAcks sent by the AP
+static void OnApPhyTxPsduBegin(ApCounters* ap,
+                               StaCounters* stats,
+                               WifiConstPsduMap psdus,
+                               WifiTxVector /*txVector*/,
+                               double /*txPowerW*/)
+{
+  const CallbackTimer timer(CB_AP);
+  for (const auto& [staId, psdu] : psdus)
+  {
+    for (const Ptr<WifiMpdu>& mpdu : *psdu)
+    {
+      const WifiMacHeader& hdr = mpdu->GetHeader();
+      if (hdr.IsTrigger())
+      {
+        CtrlTriggerHeader trigger;
+        mpdu->GetPacket()->PeekHeader(trigger);
+        if (trigger.IsBasic())
+        {
+          const uint32_t nRu = static_cast<uint32_t>(trigger.GetNUserInfoFields());
+          ap->basicTriggers++;
+          ap->rusAllocated += nRu;
+          ap->triggersByNRu[std::min(nRu, ApCounters::kMaxRuBins - 1)]++;
+        }
+        else if (trigger.IsBsrp())
+          ap->bsrpTriggers++;
+        else if (trigger.IsMuBar())
+          ap->muBarTriggers++;
+        else
+          ap->otherTriggers++;
+      }
+      else if (hdr.IsBlockAck())
+      {
+        CtrlBAckResponseHeader ba;
+        mpdu->GetPacket()->PeekHeader(ba);
+        if (!ba.IsMultiSta())
+        {
+          ap->otherBa++;
+          continue;
+        }
+        ap->multiStaBa++;
+        const size_t n = ba.GetNPerAidTidInfoSubfields();
+        for (size_t k = 0; k < n; ++k)
+        {
+          // All-ack context: Ack Type 1 with TID 14
+          const bool allAck = ba.GetAckType(k) && ba.GetTidInfo(k) == 14;
+          ap->multiStaBaEntries++;
+          ap->multiStaBaAllAck += allAck;
+          const uint16_t aid = ba.GetAid11(k);
+          const uint16_t sta = (aid < ap->aidToSta.size()) ? ap->aidToSta[aid] : ApCounters::kNoSta;
+          if (sta == ApCounters::kNoSta)
+          {
+            ap->multiStaBaUnknownAid++;
+            continue;
+          }
+          stats->mstaBaEntries[sta]++;
+          stats->mstaBaAllAck[sta] += allAck;
+        }
+      }
+    }
+  }
+}
+
+// Record the AID the AP assigned to a STA (multi-STA BlockAck attribution)
+static void OnStaAssoc(uint32_t staIndex, Ptr<StaWifiMac> mac, ApCounters* ap, Mac48Address /*bssid*/)
+{
+  const CallbackTimer timer(CB_AP);
+  const uint16_t aid = mac->GetAssociationId();
+  if (aid < ap->aidToSta.size())
+  {
+    ap->aidToSta[aid] = static_cast<uint16_t>(staIndex);
+  }
+}
+
+// ---- AP-side uplink event capture (--ulTrace) ----
+
+static uint64_t AddressKey(Mac48Address a)
+{
+  uint8_t b[6];
+  a.CopyTo(b);
+  uint64_t k = 0;
+  for (uint8_t byte : b)
+    k = (k << 8) | byte;
+  return k;
+}
+
+static fairness::UlTraceEvent UlTraceBase(const UlTraceState* t, uint8_t kind)
+{
+  fairness::UlTraceEvent e{};
+  e.timeNs = Simulator::Now().GetNanoSeconds();
+  e.run = t->run;
+  e.trigger = t->trigger;
+  e.sta = fairness::kUlTraceNoSta;
+  e.bss = t->bss;
+  e.configHash = t->configHash;
+  e.kind = kind;
+  e.ruType = fairness::kUlTraceNone;
+  e.ruIndex = fairness::kUlTraceNone;
+  e.mcs = fairness::kUlTraceNone;
+  return e;
+}
+
+// STA index of the sender of an uplink QoS data MPDU (kUlTraceNoSta otherwise)
+static uint16_t UlTraceSender(const UlTraceState* t, Ptr<const Packet> p)
+{
+  if (!p || p->GetSize() < 24)
+    return fairness::kUlTraceNoSta;
+  WifiMacHeader hdr;
+  p->PeekHeader(hdr);
+  if (!hdr.IsQosData())
+    return fairness::kUlTraceNoSta;
+  auto it = t->staByAddress.find(AddressKey(hdr.GetAddr2()));
+  return it == t->staByAddress.end() ? fairness::kUlTraceNoSta : it->second;
+}
+
+// Basic triggers sent by the AP: one TRIGGER event and one ALLOC per user info
+static void OnUlTraceApTx(UlTraceState* t, WifiConstPsduMap psdus, WifiTxVector /*txVector*/, double /*txPowerW*/)
+{
+  const CallbackTimer timer(CB_ULTRACE);
+  for (const auto& [staId, psdu] : psdus)
+  {
+    for (const Ptr<WifiMpdu>& mpdu : *psdu)
+    {
+      if (!mpdu->GetHeader().IsTrigger())
+        continue;
+      CtrlTriggerHeader trigger;
+      mpdu->GetPacket()->PeekHeader(trigger);
+      if (!trigger.IsBasic())
+        continue;
+      t->trigger++;
+      fairness::UlTraceEvent e = UlTraceBase(t, fairness::UL_TRACE_TRIGGER);
+      e.bytes = trigger.GetUlLength();
+      e.nUsers = static_cast<uint8_t>(std::min<size_t>(trigger.GetNUserInfoFields(), 255));
+      t->writer->Add(e);
+      for (const CtrlTriggerUserInfoField& user : trigger)
+      {
+        fairness::UlTraceEvent a = UlTraceBase(t, fairness::UL_TRACE_ALLOC);
+        const uint16_t aid = user.GetAid12();
+        a.sta = (aid < t->ap->aidToSta.size()) ? t->ap->aidToSta[aid] : fairness::kUlTraceNoSta;
+        const WifiRu::RuSpec ru = user.GetRuAllocation();
+        a.ruType = static_cast<uint8_t>(WifiRu::GetRuType(ru));
+        a.ruIndex = static_cast<uint8_t>(WifiRu::GetIndex(ru));
+        a.mcs = user.GetUlMcs();
+        t->writer->Add(a);
+        if (a.sta < t->alloc.size())
+          t->alloc[a.sta] = a;
+      }
+    }
+  }
+}
+
+// Uplink MPDUs the AP PHY received successfully
+static void OnUlTraceApRx(UlTraceState* t,
+                          Ptr<const Packet> p,
+                          uint16_t /*channelFreqMhz*/,
+                          WifiTxVector txVector,
+                          MpduInfo /*mpduInfo*/,
+                          SignalNoiseDbm /*signalNoise*/,
+                          uint16_t staId)
+{
+  const CallbackTimer timer(CB_ULTRACE);
+  const uint16_t sta = UlTraceSender(t, p);
+  if (sta == fairness::kUlTraceNoSta)
+    return;
+  fairness::UlTraceEvent e = UlTraceBase(t, fairness::UL_TRACE_RX);
+  e.sta = sta;
+  e.bytes = p->GetSize();
+  e.success = 1;
+  switch (txVector.GetPreambleType())
+  {
+  case WIFI_PREAMBLE_HE_TB:
+    e.ppdu = fairness::UL_PPDU_HE_TB;
+    if (txVector.GetHeMuUserInfoMap().count(staId) > 0)
+    {
+      const WifiRu::RuSpec ru = txVector.GetRu(staId);
+      e.ruType = static_cast<uint8_t>(WifiRu::GetRuType(ru));
+      e.ruIndex = static_cast<uint8_t>(WifiRu::GetIndex(ru));
+    }
+    break;
+  case WIFI_PREAMBLE_HE_SU:
+  case WIFI_PREAMBLE_HE_ER_SU:
+    e.ppdu = fairness::UL_PPDU_HE_SU;
+    break;
+  default:
+    e.ppdu = fairness::UL_PPDU_NON_HE;
+    break;
+  }
+  const WifiMode mode = txVector.GetMode(staId);
+  if (mode.GetModulationClass() >= WIFI_MOD_CLASS_HT)
+    e.mcs = mode.GetMcsValue();
+  t->writer->Add(e);
+}
+
+// Uplink MPDUs the AP PHY dropped
+static void OnUlTraceApRxDrop(UlTraceState* t, Ptr<const Packet> p, WifiPhyRxfailureReason reason)
+{
+  const CallbackTimer timer(CB_ULTRACE);
+  const uint16_t sta = UlTraceSender(t, p);
+  if (sta == fairness::kUlTraceNoSta)
+    return;
+  fairness::UlTraceEvent e = UlTraceBase(t, fairness::UL_TRACE_RX);
+  e.sta = sta;
+  e.bytes = p->GetSize();
+  e.ppdu = fairness::UL_PPDU_UNKNOWN;
+  e.reason = static_cast<uint8_t>(reason);
+  const fairness::UlTraceEvent& a = t->alloc[sta];
+  if (t->trigger > 0 && a.trigger == t->trigger)
+  {
+    e.ruType = a.ruType;
+    e.ruIndex = a.ruIndex;
+    e.mcs = a.mcs;
+  }
+  t->writer->Add(e);
+}
+
+// One packet's delay d (us) into a STA's histograms. TrackInterval also
+// feeds the per-interval histograms.
+template <bool TrackInterval>
+static void AddDelaySample(StaLatency& l, int64_t d)
+{
+  l.delayUs.Add(static_cast<uint64_t>(d));
+  if constexpr (TrackInterval)
+  {
+    l.intervalDelayUs.Add(static_cast<uint64_t>(d));
+  }
+  if (l.lastDelayUs >= 0)
+  {
+    const uint64_t j = static_cast<uint64_t>(d > l.lastDelayUs ? d - l.lastDelayUs : l.lastDelayUs - d);
+    l.jitterUs.Add(j);
+    if constexpr (TrackInterval)
+    {
+      l.intervalJitterUs.Add(j);
+    }
+  }
+  l.lastDelayUs = d;
+}
+
+// Rx callback of the AP's UplinkDemuxSink (staIndex resolved from the source
+// address).
+template <bool TrackInterval>
+static void OnSinkRx(std::vector<StaLatency>* latency, uint32_t staIndex, Ptr<const Packet> p)
+{
+  const CallbackTimer timer(CB_LATENCY);
+  UplinkTimestampTag tag;
+  if (!p->FindFirstMatchingByteTag(tag))
+    return;
+
+  AddDelaySample<TrackInterval>((*latency)[staIndex], (Simulator::Now() - tag.GetTxTime()).GetMicroSeconds());
+}
+
+// Sink callback with --flows: also files every packet under the AC of its
+// flow (from the tag). latency is null when the latency metrics are off.
+template <bool TrackInterval>
+static void OnSinkRxAc(AcCounters* acs, std::vector<StaLatency>* latency, uint32_t staIndex, Ptr<const Packet> p)
+{
+  const CallbackTimer timer(CB_LATENCY);
+  UplinkTimestampTag tag;
+  if (!p->FindFirstMatchingByteTag(tag))
+    return;
+
+  const int64_t d = (Simulator::Now() - tag.GetTxTime()).GetMicroSeconds();
+  const uint32_t ac = std::min<uint32_t>(tag.GetAc(), kNumAcs - 1);
+  const uint32_t k = ac * acs->nSta + staIndex;
+  acs->rxBytes[k] += p->GetSize();
+  acs->rxPackets[k]++;
+  acs->delayUs[ac * 2 + (staIndex >= acs->nLegacy ? 1 : 0)].Add(static_cast<uint64_t>(d));
+  if (latency)
+  {
+    AddDelaySample<TrackInterval>((*latency)[staIndex], d);
+  }
+}
+
+// BE queue Dequeue trace of a saturated STA: only the app's own packets
+// (tagged, default flow) count, not ARP or BE --flows sharing the queue.
+static void OnSaturatedQueueDequeue(Ptr<SaturatedUdpApp> app, Ptr<const WifiMpdu> mpdu)
+{
+  const CallbackTimer timer(CB_TRAFFIC);
+  UplinkTimestampTag tag;
+  if (mpdu->GetPacket()->FindFirstMatchingByteTag(tag) && tag.GetFlow() == 0)
+  {
+    app->NotifyLeftQueue();
+  }
+}
+
+// BE queue DropBeforeEnqueue trace of a saturated STA (queue full)
+static void OnSaturatedQueueReject(Ptr<SaturatedUdpApp> app, Ptr<const WifiMpdu> mpdu)
+{
+  const CallbackTimer timer(CB_TRAFFIC);
+  UplinkTimestampTag tag;
+  if (mpdu->GetPacket()->FindFirstMatchingByteTag(tag) && tag.GetFlow() == 0)
+  {
+    app->NotifyRejected();
   }
 }
+
 /**
  * Sample BE queue size for a given STA device:
  * We read the WifiMac attribute "BE_Txop" (pointer to Txop/QosTxop), then get its WifiMacQueue size.
  */
-static void SampleQueue(Ptr<WifiNetDevice> dev, uint32_t staIndex, std::vector<StaStats>* stats)
+static void SampleQueue(Ptr<WifiNetDevice> dev, uint32_t staIndex, StaCounters* stats)
 {
+  const CallbackTimer timer(CB_QUEUE);
   Ptr<WifiMac> mac = dev->GetMac();
   PointerValue pv;
   mac->GetAttribute("BE_Txop", pv); // attribute exists on WifiMac. :contentReference[oaicite:2]{index=2}
@@ -211,77 +921,663 @@ static void SampleQueue(Ptr<WifiNetDevice> dev, uint32_t staIndex, std::vector<S
   {
     qBytes = txop->GetWifiMacQueue()->GetNBytes(); // bytes currently in queue
   }
-  (*stats)[staIndex].qBytesSum += qBytes;
-  (*stats)[staIndex].qSamples++;
+  stats->qBytesSum[staIndex] += qBytes;
+  stats->qSamples[staIndex]++;
 
   Simulator::Schedule(MilliSeconds(1), &SampleQueue, dev, staIndex, stats);
 }
 
-int main(int argc, char* argv[])
+/**
+ * Event-driven alternative to SampleQueue: hooked to the enqueue/dequeue/drop
+ * traces of the STA's BE WifiMacQueue (resolved once at setup), which fire
+ * after the queue has updated its byte count. Integrates bytes x time exactly
+ * between two changes, without any periodic event.
+ */
+static void AccumulateQueueArea(uint32_t staIndex,
+                                StaCounters* stats,
+                                const std::vector<Ptr<WifiMacQueue>>* queues)
+{
+  if (!stats->queueTraced)
+    return;
+  const Time now = Simulator::Now();
+  stats->qByteSeconds[staIndex] += stats->qLastBytes[staIndex] * (now - stats->qLastChange[staIndex]).GetSeconds();
+  stats->qLastChange[staIndex] = now;
+  stats->qLastBytes[staIndex] = (*queues)[staIndex]->GetNBytes();
+}
+
+static void OnBeQueueChange(uint32_t staIndex,
+                            StaCounters* stats,
+                            const std::vector<Ptr<WifiMacQueue>>* queues,
+                            Ptr<const WifiMpdu> /*mpdu*/)
+{
+  const CallbackTimer timer(CB_QUEUE);
+  AccumulateQueueArea(staIndex, stats, queues);
+}
+
+// --flows: enqueue, dequeue or drop on the traced queue k = ac * nSta + sta
+static void OnAcQueueChange(uint32_t k, AcCounters* acs, Ptr<const WifiMpdu> /*mpdu*/)
+{
+  const CallbackTimer timer(CB_QUEUE);
+  acs->AccumulateQueue(k, Simulator::Now());
+}
+
+// --macQueueMaxSize: an MPDU rejected by a full queue
+static void OnQueueOverflow(uint64_t* overflows, Ptr<const WifiMpdu> /*mpdu*/)
 {
-  uint32_t nLegacy = 5;
-  uint32_t mHe = 5;
-  double simTime = 30.0;
-  uint32_t payloadSize = 1200;
-  uint32_t apCwMin = 15;   // default DCF CWmin
-  uint32_t apCwMax = 1023; // default DCF CWmax
+  const CallbackTimer timer(CB_QUEUE);
+  (*overflows)++;
+}
+
+// Scenario parameters shared by every replication of one invocation
+struct ScenarioConfig
+{
+  uint32_t nLegacy{5};
+  uint32_t mHe{5};
+  double simTime{30.0};
+  uint32_t payloadSize{1200};
+  std::string payloadMode{"alloc"}; // "alloc" or "template" (see PayloadMode)
+  uint32_t arrivalBatch{1};         // inter-arrival times drawn per RNG pass
+
+  // "poisson" (lambda per STA) or "saturated" (BE queue kept at satQueueDepth)
+  std::string trafficModel{"poisson"};
+  uint32_t satQueueDepth{128}; // packets
+
+  // Extra uplink flows per STA on any AC (--flows, see ParseFlows; parsed
+  // by main), e.g. VO/VI next to the default BE flow
+  std::string flowsList{""};
+  std::vector<FlowSpec> flows;
+  uint32_t apCwMin{15};   // default DCF CWmin
+  uint32_t apCwMax{1023}; // default DCF CWmax
 
   // If lambdaList is provided, it applies to ALL STAs in order:
   // [0..nLegacy-1]=legacy, [nLegacy..nLegacy+mHe-1]=HE
   // If not provided, we use lambdaLegacy for legacy and lambdaHe for HE.
-  std::string lambdaListCsv = "";
-  double lambdaLegacy = 1000.0; // pkts/s
-  double lambdaHe = 1000.0;     // pkts/s
+  std::string lambdaListCsv{""};
+  double lambdaLegacy{1000.0}; // pkts/s
+  double lambdaHe{1000.0};     // pkts/s
 
   // UL OFDMA scheduler knobs
-  bool enableUlOfdma = true;
-  Time muAccessReqInterval = MilliSeconds(0);
+  bool enableUlOfdma{true};
+  Time muAccessReqInterval{MilliSeconds(0)};
+  // "rr" (plain round robin) or "fair" (FairRrMultiUserScheduler, which
+  // adapts the access request interval and RUs per trigger online towards
+  // fairTargetJain every fairControlInterval)
+  std::string muScheduler{"rr"};
+  double fairTargetJain{0.95};
+  Time fairControlInterval{MilliSeconds(50)};
+
+  // AP CW controller: "off" (apCwMin/apCwMax fixed) or "pi" (retunes the AP
+  // BE CW every cwControlInterval towards Jain_group = cwTargetJain, see
+  // CwControlStep)
+  std::string cwControl{"off"};
+  double cwTargetJain{0.95};
+  Time cwControlInterval{MilliSeconds(100)};
+  double cwKp{4.0};  // octaves per unit of Jain error
+  double cwKi{20.0}; // octaves per unit of Jain error and second
+
+  // PHY error model: "spectrum" (TableBasedErrorRateModel on every chunk) or
+  // "abstract" (CachedErrorRateModel, SNR quantised to abstractSnrStepDb); the
+  // spectrum PHY's PSD interference path is the same in both
+  std::string phyModel{"spectrum"};
+  double abstractSnrStepDb{0.25};
+
+  // BE queue occupancy metric: "trace" (time-weighted) or "poll" (1 ms sampler)
+  std::string queueSampling{"trace"};
+
+  // Metric groups whose traces are connected (MetricFlags, within
+  // kCompiledMetrics) and the --metrics list they came from
+  uint32_t metrics{kCompiledMetrics};
+  std::string metricsList{"all"};
+
+  // Print the analytical model's prediction for the point after each result block
+  bool printModel{false};
+
+  // STA placement around the AP: "line" (1 m + 0.1 m per STA, the original
+  // layout) or "disc" (evenly spread over a disc of placementRadius metres)
+  std::string placement{"line"};
+  double placementRadius{5.0};
+
+  // Print setup/run wall time, simulator events and peak RSS per replication
+  bool reportPerf{false};
+
+  // Long runs: cap of every STA's BE WifiMacQueue (QueueSize, e.g. "64p";
+  // empty: the WifiMacQueue default) and one "Memory:" line per replication.
+  // longRun sets both (macQueueMaxSize 100p unless given).
+  bool longRun{false};
+  std::string macQueueMaxSize{""};
+  bool reportMemory{false};
+
+  // Multi-BSS floor: nBss cells (one AP + nLegacy + mHe STAs each) on a
+  // square grid bssSpacing metres apart, cell b on channel b % channelReuse
+  // of kBssChannels. With mpi, co-channel cells stay on one rank and the
+  // channel groups are dealt round-robin to the ranks (filled in by main).
+  uint32_t nBss{1};
+  double bssSpacing{20.0};
+  uint32_t channelReuse{1};
+  bool mpi{false};
+  uint32_t mpiRank{0};
+  uint32_t mpiSize{1};
+
+  // Live interval records every intervalMs of simulated time after appStart
+  // (0: off), written to a non-blocking RecordStream (see main)
+  uint32_t intervalMs{0};
+
+  // Measurement window: "fixed" starts measuring warmup seconds after
+  // appStart; "mser" starts once an online MSER-5 test on warmupSampleMs
+  // observations of network throughput (and BE queue bytes) accepts a
+  // truncation point, at the latest warmupMax seconds after appStart
+  // (< 0: simTime / 2). All reported metrics cover the window only.
+  std::string warmupMode{"fixed"};
+  double warmup{0.0};
+  uint32_t warmupSampleMs{2};
+  double warmupMax{-1.0};
+
+  // Random stream numbering: "auto" (ns-3 creation order, the original
+  // behaviour) or "perSta" (fixed per-cell/per-STA blocks, see
+  // kStreamsPerBlock)
+  std::string rngStreams{"auto"};
+};
 
-  CommandLine cmd(__FILE__);
-  cmd.AddValue("nLegacy", "Number of 802.11ac (HT) stations", nLegacy);
-  cmd.AddValue("mHe", "Number of 802.11ax (HE) stations", mHe);
-  cmd.AddValue("simTime", "Simulation time (s) after apps start", simTime);
-  cmd.AddValue("payloadSize", "UDP payload size (bytes)", payloadSize);
-  cmd.AddValue("lambdaList", "Comma-separated lambdas (pkts/s) per station (legacy first, then HE)", lambdaListCsv);
-  cmd.AddValue("lambdaLegacy", "Default lambda (pkts/s) for legacy STAs if lambdaList is empty", lambdaLegacy);
-  cmd.AddValue("lambdaHe", "Default lambda (pkts/s) for HE STAs if lambdaList is empty", lambdaHe);
-  cmd.AddValue("apCwMin", "AP BE CWmin (DCF)", apCwMin);
-  cmd.AddValue("apCwMax", "AP BE CWmax (DCF)", apCwMax);
-  cmd.AddValue("enableUlOfdma", "Enable UL OFDMA in MU scheduler", enableUlOfdma);
-  cmd.AddValue("muAccessReqInterval", "MU scheduler access request interval (e.g., 0ms, 2ms)", muAccessReqInterval);
-  cmd.Parse(argc, argv);
+// Non-overlapping 20 MHz channels (5 GHz UNII-1/2) used for channel reuse
+static const uint8_t kBssChannels[] = {36, 40, 44, 48, 52, 56, 60, 64};
 
-  const uint32_t nTotal = nLegacy + mHe;
+// Where one BSS of the floor is built and which rank owns it
+struct CellLayout
+{
+  uint32_t bss{0};
+  uint32_t systemId{0};
+  uint8_t channelNumber{36};
+  Vector center{0.0, 0.0, 0.0};
+  // Shared by the co-channel cells of this rank; BuildReplication creates a
+  // private one (no propagation loss, the single-BSS model) when null.
+  Ptr<MultiModelSpectrumChannel> channel;
+};
 
-  // ---- Nodes ----
-  NodeContainer apNode;
-  apNode.Create(1);
+// --cwControl=pi: PI controller state, acting on u = log2(CWmin + 1)
+struct CwController
+{
+  double target{0.95};
+  double kp{4.0};
+  double ki{20.0};
+  Time period;
+  double u0{4.0};    // setpoint offset: the configured CWmin
+  double ratio{6.0}; // log2((CWmax + 1) / (CWmin + 1)), kept constant
+  double u{4.0};
+  double integral{0.0};
+  uint64_t lastHeRxBytes{0};
+  uint64_t lastLegacyRxBytes{0};
+  uint64_t steps{0};
+};
 
-  NodeContainer staLegacy;
-  staLegacy.Create(nLegacy);
+// AP knobs that differ between the points of a warm-start group
+struct PointSettings
+{
+  Time muAccessReqInterval;
+  uint32_t apCwMin;
+  uint32_t apCwMax;
+};
 
-  NodeContainer staHe;
-  staHe.Create(mHe);
+/**
+ * Everything a replication needs after setup: the trace sinks are bound to
+ * the vectors below, so a Replication must stay at a fixed address (and
+ * alive) until the simulator is destroyed.
+ */
+struct Replication
+{
+  uint32_t bss{0};
+  uint8_t channelNumber{36};
+  uint32_t nLegacy{0};
+  uint32_t mHe{0};
+  uint32_t nTotal{0};
+  Time appStart;
+  Time appStop;
+
+  Ptr<Txop> apBeTxop;
+  Ptr<MultiUserScheduler> apMuScheduler;
+  Ptr<WifiNetDevice> apDevice;
+  std::vector<Ptr<WifiNetDevice>> staDevices; // legacy first, then HE
+
+  std::vector<double> lambdas;
+  Ptr<UplinkDemuxSink> sink;
+  std::vector<StaLatency> latency;
+  AcCounters acStats; // --flows only
+  UlTraceState ulTrace; // --ulTrace only
+  StaCounters stats;
+  ApCounters ap;
+  bool pollQueue{false};
+  std::vector<Ptr<WifiMacQueue>> beQueues;
+  uint64_t queueOverflows{0}; // all STAs, --macQueueMaxSize only
+
+  // AP settings in effect (labels the interval records) and the hash of
+  // the config they belong to (see ConfigString)
+  PointSettings point;
+  uint64_t configHash{0};
+
+  bool cwControl{false};
+  CwController cw;
+
+  // Measurement window: counters at measureStart (zeros and 0 s when the
+  // whole run is measured)
+  bool windowed{false};
+  Time measureStart;
+  std::string warmupNote;
+  StaCounters measureBase;
+  ApCounters measureApBase;
+  std::vector<uint64_t> measureRxBytesBase;
+  uint64_t measureAccessReqBase{0}; // fair MU scheduler: access requests at appStart/measureStart
+
+  // --warmupMode=mser: raw observations so far and the previous sample
+  std::vector<double> mserThr;
+  std::vector<double> mserQueue;
+  uint64_t mserLastRxBytes{0};
+
+  // --intervalMs: counters at the start of the current interval
+  uint32_t intervalIndex{0};
+  Time intervalStart;
+  StaCounters intervalBase;
+  std::vector<uint64_t> intervalRxBytesBase;
+  std::vector<uint64_t> intervalRxPacketsBase;
+};
 
-  NodeContainer allStas;
-  allStas.Add(staLegacy);
-  allStas.Add(staHe);
+// ---- Measurement window (--warmup / --warmupMode) ----
 
-  // ---- PHY/channel (Spectrum is used; required/typical when OFDMA is enabled) ----
-  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+/**
+ * MSER-5 truncation point of the raw observations y: with Z_1..Z_n the means
+ * of batches of 5, d* minimises sum_{j>d} (Z_j - mean_{>d})^2 / (n - d)^2
+ * over d <= n - 5. Returns d* (in batches), or -1 while fewer than 10 batches
+ * exist or d* >= n/2, i.e. the series does not show a steady state yet.
+ */
+static int MserTruncation(const std::vector<double>& y)
+{
+  const size_t n = y.size() / 5;
+  if (n < 10)
+    return -1;
 
-  SpectrumWifiPhyHelper phy;
-  phy.SetChannel(channel);
-  phy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
+  std::vector<double> z(n);
+  for (size_t j = 0; j < n; ++j)
+  {
+    z[j] = (y[5 * j] + y[5 * j + 1] + y[5 * j + 2] + y[5 * j + 3] + y[5 * j + 4]) / 5.0;
+  }
 
-  // 20 MHz @ 5 GHz, channel 36 (common)
-  // Format used by ns-3 Wi-Fi examples: "{channelNumber, channelWidth, band, 0}"
-  // Example file uses ChannelSettings like this. :contentReference[oaicite:3]{index=3}
-  phy.Set("ChannelSettings", StringValue("{36, 20, BAND_5GHZ, 0}"));
+  // Suffix sums from the end; on ties the smaller d wins.
+  double sum = 0.0;
+  double sumSq = 0.0;
+  double best = std::numeric_limits<double>::infinity();
+  size_t bestD = 0;
+  for (size_t d = n; d-- > 0;)
+  {
+    sum += z[d];
+    sumSq += z[d] * z[d];
+    const double m = static_cast<double>(n - d);
+    if (n - d < 5)
+      continue;
+    const double stat = std::max(0.0, sumSq - sum * sum / m) / (m * m);
+    if (stat <= best)
+    {
+      best = stat;
+      bestD = d;
+    }
+  }
+  return (2 * bestD < n) ? static_cast<int>(bestD) : -1;
+}
 
-  Ssid ssid = Ssid("mixed-ul");
+// Access requests of the fair MU scheduler before the measured interval
+static void SnapshotAccessRequests(Replication* rep)
+{
+  if (Ptr<FairRrMultiUserScheduler> fair = DynamicCast<FairRrMultiUserScheduler>(rep->apMuScheduler))
+  {
+    rep->measureAccessReqBase = fair->GetAccessRequests();
+  }
+}
 
-  // ---- Install AP (HE / 802.11ax) ----
+// Rebase every reported metric at Now(): the measurement window starts here.
+static void StartMeasurement(Replication* rep, std::string note)
+{
+  if (!rep->pollQueue)
+  {
+    for (uint32_t i = 0; i < rep->nTotal; ++i)
+    {
+      AccumulateQueueArea(i, &rep->stats, &rep->beQueues);
+    }
+  }
+  rep->measureBase = rep->stats;
+  rep->measureApBase = rep->ap;
+  rep->measureRxBytesBase = rep->sink->GetRxBytes();
+  SnapshotAccessRequests(rep);
+  rep->measureStart = Simulator::Now();
+  rep->warmupNote = std::move(note);
+  if (rep->acStats.nSta > 0)
+  {
+    rep->acStats.Rebase(rep->measureStart);
+  }
+  for (StaLatency& l : rep->latency)
+  {
+    l.delayUs.Reset();
+    l.jitterUs.Reset();
+  }
+  std::vector<double>().swap(rep->mserThr);
+  std::vector<double>().swap(rep->mserQueue);
+}
+
+/**
+ * One observation of the online MSER-5 warm-up test. Measurement starts at
+ * the first sample where both series accept a truncation point (so the
+ * window begins at detection, after the detected transient), or at deadline.
+ */
+static void WarmupSample(Replication* rep, Time period, Time deadline)
+{
+  const CallbackTimer timer(CB_CONTROL);
+  uint64_t rx = 0;
+  for (uint64_t b : rep->sink->GetRxBytes())
+  {
+    rx += b;
+  }
+  rep->mserThr.push_back((rx - rep->mserLastRxBytes) * 8.0 / period.GetSeconds());
+  rep->mserLastRxBytes = rx;
+  if (!rep->pollQueue)
+  {
+    double q = 0.0;
+    for (const Ptr<WifiMacQueue>& queue : rep->beQueues)
+    {
+      q += queue->GetNBytes();
+    }
+    rep->mserQueue.push_back(q);
+  }
+
+  if (rep->mserThr.size() % 5 == 0)
+  {
+    const int dThr = MserTruncation(rep->mserThr);
+    const int dQueue = rep->pollQueue ? 0 : MserTruncation(rep->mserQueue);
+    if (dThr >= 0 && dQueue >= 0)
+    {
+      std::ostringstream note;
+      note << "mser, transient=" << (std::max(dThr, dQueue) * 5 * period).GetSeconds() << "s";
+      StartMeasurement(rep, note.str());
+      return;
+    }
+  }
+  if (Simulator::Now() + period > deadline)
+  {
+    StartMeasurement(rep, "mser, not converged");
+    return;
+  }
+  Simulator::Schedule(period, &WarmupSample, rep, period, deadline);
+}
+
+// Schedule the start of the measurement window (no-op: measure from appStart)
+static void ArmMeasurementWindow(const ScenarioConfig& cfg, Replication* rep)
+{
+  if (cfg.warmupMode == "fixed")
+  {
+    if (cfg.warmup <= 0.0)
+      return;
+    rep->windowed = true;
+    Simulator::Schedule(rep->appStart + Seconds(cfg.warmup) - Simulator::Now(), &StartMeasurement, rep,
+                        std::string("fixed"));
+    return;
+  }
+
+  rep->windowed = true;
+  const Time period = MilliSeconds(cfg.warmupSampleMs);
+  const double maxWarmup = (cfg.warmupMax >= 0.0) ? cfg.warmupMax : cfg.simTime / 2;
+  Simulator::Schedule(rep->appStart + period - Simulator::Now(), &WarmupSample, rep, period,
+                      rep->appStart + Seconds(maxWarmup));
+}
+
+// --muScheduler=fair: what the AP could know of its BSS (sink bytes per
+// group, HE stations with a backlog)
+static FairRrMultiUserScheduler::GroupState ObserveGroups(const Replication* rep)
+{
+  const CallbackTimer timer(CB_CONTROL);
+  FairRrMultiUserScheduler::GroupState s;
+  s.nLegacy = rep->nLegacy;
+  s.nHe = rep->mHe;
+  const std::vector<uint64_t>& rxBytes = rep->sink->GetRxBytes();
+  for (uint32_t i = 0; i < rep->nTotal; ++i)
+  {
+    if (i < rep->nLegacy)
+    {
+      s.legacyRxBytes += rxBytes[i];
+    }
+    else
+    {
+      s.heRxBytes += rxBytes[i];
+      s.heBacklogged += (rep->beQueues[i]->GetNBytes() > 0);
+    }
+  }
+  return s;
+}
+
+// ---- AP CW controller (--cwControl) ----
+
+// Apply u = log2(CWmin + 1) to the AP BE Txop, CWmax keeping the configured ratio
+static void SetApCw(Replication* rep, double u)
+{
+  const uint32_t cwMin = static_cast<uint32_t>(std::lround(std::exp2(u))) - 1;
+  const uint32_t cwMax =
+    std::max(cwMin, std::min<uint32_t>(1023, static_cast<uint32_t>(std::lround(std::exp2(u + rep->cw.ratio))) - 1));
+  if (cwMin == rep->point.apCwMin && cwMax == rep->point.apCwMax)
+    return;
+  rep->apBeTxop->SetMinCw(cwMin);
+  rep->apBeTxop->SetMaxCw(cwMax);
+  rep->point.apCwMin = cwMin;
+  rep->point.apCwMax = cwMax;
+}
+
+// (Re)start the controller from the AP CW pair currently in effect
+static void ResetCwController(Replication* rep)
+{
+  CwController& c = rep->cw;
+  c.u0 = std::log2(rep->point.apCwMin + 1.0);
+  c.ratio = std::max(0.0, std::log2((rep->point.apCwMax + 1.0) / (rep->point.apCwMin + 1.0)));
+  c.u = c.u0;
+  c.integral = 0.0;
+}
+
+/**
+ * One controller period. With he and legacy the mean per-STA sink
+ * throughputs of the period and J their two-group Jain index, the signed
+ * unfairness d = sign(he - legacy) * (1 - J) is driven to the boundary of the
+ * feasible region on the HE side, d* = 1 - target (where the best feasible
+ * pairs of compute_best_feasible lie). A smaller AP CW wins more trigger
+ * opportunities for the HE STAs, so the error e = d - d* (clamped to
+ * +-0.25) raises CWmin when HE STAs are too far ahead and lowers it
+ * otherwise: u = u0 + kp * e + ki * integral(e dt), clamped to CWmin in
+ * [0, 1023] (the integral is frozen while clamped). The error is not
+ * normalised by 1 - target: that gain blows up near target = 1 and the loop
+ * then limit-cycles between the CW bounds.
+ */
+static void CwControlStep(Replication* rep)
+{
+  const CallbackTimer timer(CB_CONTROL);
+  CwController& c = rep->cw;
+  Simulator::Schedule(c.period, &CwControlStep, rep);
+
+  const std::vector<uint64_t>& rxBytes = rep->sink->GetRxBytes();
+  uint64_t heRx = 0;
+  uint64_t legacyRx = 0;
+  for (uint32_t i = 0; i < rep->nTotal; ++i)
+  {
+    (i < rep->nLegacy ? legacyRx : heRx) += rxBytes[i];
+  }
+  const double he = static_cast<double>(heRx - c.lastHeRxBytes) / rep->mHe;
+  const double legacy = static_cast<double>(legacyRx - c.lastLegacyRxBytes) / rep->nLegacy;
+  c.lastHeRxBytes = heRx;
+  c.lastLegacyRxBytes = legacyRx;
+  if (he + legacy <= 0.0)
+    return; // idle period: no information
+
+  const double jain = (he + legacy) * (he + legacy) / (2.0 * (he * he + legacy * legacy));
+  const double d = (he >= legacy ? 1.0 : -1.0) * (1.0 - jain);
+  const double e = std::clamp(d - (1.0 - c.target), -0.25, 0.25);
+
+  const double integral = c.integral + e * c.period.GetSeconds();
+  const double u = c.u0 + c.kp * e + c.ki * integral;
+  c.u = std::clamp(u, 0.0, 10.0);
+  if (c.u == u)
+    c.integral = integral;
+  c.steps++;
+  SetApCw(rep, c.u);
+}
+
+static void StartCwControl(const ScenarioConfig& cfg, Replication* rep)
+{
+  if (cfg.cwControl != "pi")
+    return;
+  rep->cwControl = true;
+  rep->cw.target = cfg.cwTargetJain;
+  rep->cw.kp = cfg.cwKp;
+  rep->cw.ki = cfg.cwKi;
+  rep->cw.period = cfg.cwControlInterval;
+  ResetCwController(rep);
+  Simulator::Schedule(rep->appStart + rep->cw.period - Simulator::Now(), &CwControlStep, rep);
+}
+
+// ---- Reproducibility: fixed random streams and the run manifest ----
+
+/**
+ * --rngStreams=perSta gives every random variable of a cell a fixed stream
+ * number, so a STA's draws depend on (RngSeed, RngRun, cell, STA) only and
+ * adding or removing STAs leaves the other STAs' sequences unchanged (with
+ * "auto", ns-3 numbers streams in creation order and they shift). Cell b
+ * owns streams [b << 32, (b + 1) << 32) in blocks of kStreamsPerBlock: block
+ * 0 is the AP, legacy STA j is block 1 + 2j and HE STA j block 2 + 2j
+ * (interleaved, so neither group shifts the other). Within a block the
+ * WifiNetDevice (PHY, MAC, station manager) starts at offset 0, the IP stack
+ * at kIpStreamOffset and the traffic sources at kAppStreamOffset, one slot
+ * of PoissonUdpApp::kNumStreams for the default flow and then one per
+ * --flows entry (used or not). Automatic streams are numbered from 2^63
+ * upwards and never collide with these.
+ */
+static constexpr int64_t kStreamsPerBlock = 256;
+static constexpr int64_t kIpStreamOffset = 64;
+static constexpr int64_t kAppStreamOffset = 96;
+static constexpr uint32_t kMaxAppSlots = (kStreamsPerBlock - kAppStreamOffset) / PoissonUdpApp::kNumStreams;
+
+static int64_t StreamBlock(uint32_t bss, uint64_t block)
+{
+  return (static_cast<int64_t>(bss) << 32) + static_cast<int64_t>(block) * kStreamsPerBlock;
+}
+
+// Fix the streams of one node's block; apps[k] is the source of app slot k
+// (null: none, e.g. saturated traffic or a flow that skips this STA)
+static void AssignBlockStreams(WifiHelper& wifi,
+                               InternetStackHelper& stack,
+                               int64_t base,
+                               Ptr<NetDevice> dev,
+                               Ptr<Node> node,
+                               const std::vector<Ptr<PoissonUdpApp>>& apps)
+{
+  const int64_t wifiStreams = wifi.AssignStreams(NetDeviceContainer(dev), base);
+  const int64_t ipStreams = stack.AssignStreams(NodeContainer(node), base + kIpStreamOffset);
+  NS_ABORT_MSG_IF(wifiStreams > kIpStreamOffset || ipStreams > kAppStreamOffset - kIpStreamOffset,
+                  "--rngStreams=perSta: a node uses more streams than its block reserves");
+  for (size_t k = 0; k < apps.size(); ++k)
+  {
+    if (apps[k])
+      apps[k]->AssignStreams(base + kAppStreamOffset + static_cast<int64_t>(k) * PoissonUdpApp::kNumStreams);
+  }
+}
+
+/**
+ * Canonical "key=value ..." list of every simulation input in cfg, in
+ * ScenarioConfig order. Output and reporting options are left out, as are
+ * RngSeed and RngRun (printed next to it), so all replications of a point
+ * share the string and its hash.
+ */
+static std::string ConfigString(const ScenarioConfig& cfg)
+{
+  std::ostringstream os;
+  os.precision(12);
+  os << "nLegacy=" << cfg.nLegacy << " mHe=" << cfg.mHe << " simTime=" << cfg.simTime
+     << " payloadSize=" << cfg.payloadSize << " payloadMode=" << cfg.payloadMode
+     << " arrivalBatch=" << cfg.arrivalBatch << " trafficModel=" << cfg.trafficModel
+     << " satQueueDepth=" << cfg.satQueueDepth << " flows=" << cfg.flowsList << " apCwMin=" << cfg.apCwMin
+     << " apCwMax=" << cfg.apCwMax << " lambdaList=" << cfg.lambdaListCsv << " lambdaLegacy=" << cfg.lambdaLegacy
+     << " lambdaHe=" << cfg.lambdaHe << " enableUlOfdma=" << cfg.enableUlOfdma
+     << " muAccessReqInterval=" << cfg.muAccessReqInterval.GetSeconds() << " muScheduler=" << cfg.muScheduler
+     << " fairTargetJain=" << cfg.fairTargetJain
+     << " fairControlInterval=" << cfg.fairControlInterval.GetSeconds() << " cwControl=" << cfg.cwControl
+     << " cwTargetJain=" << cfg.cwTargetJain << " cwControlInterval=" << cfg.cwControlInterval.GetSeconds()
+     << " cwKp=" << cfg.cwKp << " cwKi=" << cfg.cwKi << " phyModel=" << cfg.phyModel
+     << " abstractSnrStepDb=" << cfg.abstractSnrStepDb << " queueSampling=" << cfg.queueSampling
+     << " metrics=" << cfg.metrics << " placement=" << cfg.placement << " placementRadius=" << cfg.placementRadius
+     << " macQueueMaxSize=" << cfg.macQueueMaxSize << " nBss=" << cfg.nBss << " bssSpacing=" << cfg.bssSpacing
+     << " channelReuse=" << cfg.channelReuse << " warmupMode=" << cfg.warmupMode << " warmup=" << cfg.warmup
+     << " warmupSampleMs=" << cfg.warmupSampleMs << " warmupMax=" << cfg.warmupMax
+     << " rngStreams=" << cfg.rngStreams;
+  return os.str();
+}
+
+// 64-bit FNV-1a
+static uint64_t ConfigHash(const std::string& config)
+{
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (unsigned char c : config)
+  {
+    h = (h ^ c) * 0x100000001b3ull;
+  }
+  return h;
+}
+
+/**
+ * Build the topology of one replication (one BSS, placed and tuned as
+ * described by cell) with the current RngRun and hook all statistics
+ * traces. Nothing is scheduled beyond what the helpers, the statistics and
+ * the measurement window need; the caller decides how far to run.
+ */
+static void BuildReplication(const ScenarioConfig& cfg, const CellLayout& cell, Replication* rep)
+{
+  const uint32_t nLegacy = cfg.nLegacy;
+  const uint32_t mHe = cfg.mHe;
+  const double simTime = cfg.simTime;
+  const uint32_t nTotal = nLegacy + mHe;
+  rep->bss = cell.bss;
+  rep->channelNumber = cell.channelNumber;
+  rep->nLegacy = nLegacy;
+  rep->mHe = mHe;
+  rep->nTotal = nTotal;
+
+  // ---- Nodes (owned by the cell's MPI rank; 0 without MPI) ----
+  NodeContainer apNode;
+  apNode.Create(1, cell.systemId);
+
+  NodeContainer staLegacy;
+  staLegacy.Create(nLegacy, cell.systemId);
+
+  NodeContainer staHe;
+  staHe.Create(mHe, cell.systemId);
+
+  NodeContainer allStas;
+  allStas.Add(staLegacy);
+  allStas.Add(staHe);
+
+  // ---- PHY/channel (Spectrum is used; required/typical when OFDMA is enabled) ----
+  Ptr<MultiModelSpectrumChannel> channel = cell.channel;
+  if (!channel)
+  {
+    channel = CreateObject<MultiModelSpectrumChannel>();
+  }
+
+  SpectrumWifiPhyHelper phy;
+  phy.SetChannel(channel);
+  phy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
+
+  // 20 MHz @ 5 GHz, channel 36 unless the cell is assigned another one
+  // Format used by ns-3 Wi-Fi examples: "{channelNumber, channelWidth, band, 0}"
+  // Example file uses ChannelSettings like this. :contentReference[oaicite:3]{index=3}
+  phy.Set("ChannelSettings",
+          StringValue("{" + std::to_string(cell.channelNumber) + ", 20, BAND_5GHZ, 0}"));
+  if (cfg.phyModel == "abstract")
+  {
+    // Static geometry: memoise the error model per quantised link SNR
+    phy.SetErrorRateModel("ns3::CachedErrorRateModel", "SnrStepDb", DoubleValue(cfg.abstractSnrStepDb));
+  }
+
+  // Each cell has its own SSID, so STAs only associate with their own AP
+  Ssid ssid = Ssid(cell.bss == 0 ? std::string("mixed-ul") : "mixed-ul-" + std::to_string(cell.bss));
+
+  // ---- Install AP (HE / 802.11ax) ----
   WifiHelper wifiAp;
   wifiAp.SetStandard(WIFI_STANDARD_80211ax);
 
@@ -289,10 +1585,22 @@ int main(int argc, char* argv[])
 
   // Attach MU scheduler at AP (Round-Robin), and enable UL OFDMA flag
   // (Same pattern as official HE example.) :contentReference[oaicite:4]{index=4}
-  macAp.SetMultiUserScheduler("ns3::RrMultiUserScheduler",
-                              "EnableUlOfdma", BooleanValue(enableUlOfdma),
-                              "EnableBsrp", BooleanValue(false),
-                              "AccessReqInterval", TimeValue(muAccessReqInterval));
+  if (cfg.muScheduler == "fair")
+  {
+    macAp.SetMultiUserScheduler("ns3::FairRrMultiUserScheduler",
+                                "EnableUlOfdma", BooleanValue(cfg.enableUlOfdma),
+                                "EnableBsrp", BooleanValue(false),
+                                "AccessReqInterval", TimeValue(cfg.muAccessReqInterval),
+                                "TargetJain", DoubleValue(cfg.fairTargetJain),
+                                "ControlInterval", TimeValue(cfg.fairControlInterval));
+  }
+  else
+  {
+    macAp.SetMultiUserScheduler("ns3::RrMultiUserScheduler",
+                                "EnableUlOfdma", BooleanValue(cfg.enableUlOfdma),
+                                "EnableBsrp", BooleanValue(false),
+                                "AccessReqInterval", TimeValue(cfg.muAccessReqInterval));
+  }
 
   macAp.SetType("ns3::ApWifiMac",
                 "Ssid", SsidValue(ssid),
@@ -312,11 +1620,16 @@ int main(int argc, char* argv[])
   NS_ASSERT(beTxop);
 
   // Set CWmin / CWmax for AP
-  beTxop->SetMinCw(apCwMin);
-  beTxop->SetMaxCw(apCwMax);
+  beTxop->SetMinCw(cfg.apCwMin);
+  beTxop->SetMaxCw(cfg.apCwMax);
+  rep->apBeTxop = beTxop;
+  rep->apDevice = apWifiDev;
+  rep->apMuScheduler = apMac->GetObject<MultiUserScheduler>();
+  rep->point = PointSettings{cfg.muAccessReqInterval, cfg.apCwMin, cfg.apCwMax};
+  rep->configHash = ConfigHash(ConfigString(cfg));
 
-  //NS_LOG_UNCOND("AP BE CW configured: CWmin=" << apCwMin
-  //              << ", CWmax=" << apCwMax);
+  //NS_LOG_UNCOND("AP BE CW configured: CWmin=" << cfg.apCwMin
+  //              << ", CWmax=" << cfg.apCwMax);
 
   // ---- Install legacy STAs (HT / 802.11ac) sharing same channel ----
   WifiHelper wifiLegacy;
@@ -359,11 +1672,24 @@ int main(int argc, char* argv[])
   MobilityHelper mobility;
   mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
 
+  // Positions relative to the cell's AP
+  const Vector& c = cell.center;
   Ptr<ListPositionAllocator> pos = CreateObject<ListPositionAllocator>();
-  pos->Add(Vector(0.0, 0.0, 0.0)); // AP
+  pos->Add(c); // AP
   for (uint32_t i = 0; i < nTotal; ++i)
   {
-    pos->Add(Vector(1.0 + 0.1 * i, 0.0, 0.0));
+    if (cfg.placement == "disc")
+    {
+      // Sunflower (golden-angle) spiral: equal area per STA, 0.5 m minimum
+      // distance to the AP, no RNG draws (stream numbering is unchanged).
+      const double goldenAngle = M_PI * (3.0 - std::sqrt(5.0));
+      const double r = 0.5 + (cfg.placementRadius - 0.5) * std::sqrt((i + 0.5) / nTotal);
+      pos->Add(Vector(c.x + r * std::cos(i * goldenAngle), c.y + r * std::sin(i * goldenAngle), c.z));
+    }
+    else
+    {
+      pos->Add(Vector(c.x + 1.0 + 0.1 * i, c.y, c.z));
+    }
   }
   mobility.SetPositionAllocator(pos);
   mobility.Install(apNode);
@@ -375,15 +1701,19 @@ int main(int argc, char* argv[])
   stack.Install(allStas);
 
   Ipv4AddressHelper addr;
-  addr.SetBase("10.1.0.0", "255.255.255.0");
+  // /16: room for thousands of STAs, all on consecutive addresses (the
+  // uplink sink relies on that to map a source address to a STA index)
+  // Cell b uses 10.(1+b).0.0/16.
+  addr.SetBase(Ipv4Address((10u << 24) | ((1u + cell.bss) << 16)), "255.255.0.0");
   Ipv4InterfaceContainer apIf = addr.Assign(apDev);
 
   Ipv4InterfaceContainer legacyIf = addr.Assign(legacyDevs);
   Ipv4InterfaceContainer heIf = addr.Assign(heDevs);
 
   // ---- Lambda assignment ----
-  std::vector<double> lambdas(nTotal, 0.0);
-  auto parsed = ParseCsvDoubles(lambdaListCsv);
+  std::vector<double>& lambdas = rep->lambdas;
+  lambdas.assign(nTotal, 0.0);
+  auto parsed = ParseCsvDoubles(cfg.lambdaListCsv);
   if (!parsed.empty())
   {
     for (uint32_t i = 0; i < nTotal; ++i)
@@ -393,44 +1723,158 @@ int main(int argc, char* argv[])
   }
   else
   {
-    for (uint32_t i = 0; i < nLegacy; ++i) lambdas[i] = lambdaLegacy;
-    for (uint32_t j = 0; j < mHe; ++j) lambdas[nLegacy + j] = lambdaHe;
+    for (uint32_t i = 0; i < nLegacy; ++i) lambdas[i] = cfg.lambdaLegacy;
+    for (uint32_t j = 0; j < mHe; ++j) lambdas[nLegacy + j] = cfg.lambdaHe;
   }
 
-  // ---- Per-station sinks at AP (one port per STA) ----
-  const uint16_t basePort = 40000;
-  std::vector<Ptr<PacketSink>> sinks(nTotal);
-
+  // ---- One sink at AP for all stations, demultiplexed by source address ----
+  const uint16_t sinkPort = 40000;
+  const Ipv4Address firstStaAddr =
+    (nLegacy > 0) ? legacyIf.GetAddress(0) : (mHe > 0 ? heIf.GetAddress(0) : Ipv4Address::GetAny());
   for (uint32_t i = 0; i < nTotal; ++i)
   {
-    Address sinkLocal(InetSocketAddress(Ipv4Address::GetAny(), basePort + i));
-    PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", sinkLocal);
-    ApplicationContainer sinkApp = sinkHelper.Install(apNode.Get(0));
-    sinkApp.Start(Seconds(0.0));
-    sinkApp.Stop(Seconds(1.0 + simTime + 0.1));
+    const Ipv4Address a = (i < nLegacy) ? legacyIf.GetAddress(i) : heIf.GetAddress(i - nLegacy);
+    NS_ABORT_MSG_IF(a.Get() != firstStaAddr.Get() + i, "STA addresses are not consecutive");
+  }
+
+  std::vector<StaLatency>& latency = rep->latency;
+  latency.assign(nTotal, StaLatency{});
+  rep->acStats.Reset(cfg.flows.empty() ? 0 : nTotal, nLegacy);
 
-    sinks[i] = DynamicCast<PacketSink>(sinkApp.Get(0));
+  Ptr<UplinkDemuxSink> sink = CreateObject<UplinkDemuxSink>();
+  sink->Setup(Socket::CreateSocket(apNode.Get(0), UdpSocketFactory::GetTypeId()), sinkPort, firstStaAddr, nTotal);
+  // Without latency metrics or extra flows the sink only counts bytes (no callback)
+  if (!cfg.flows.empty())
+  {
+    std::vector<StaLatency>* lat = (cfg.metrics & METRIC_LATENCY) ? &latency : nullptr;
+    if (cfg.intervalMs > 0)
+      sink->SetRxCallback(MakeBoundCallback(&OnSinkRxAc<true>, &rep->acStats, lat));
+    else
+      sink->SetRxCallback(MakeBoundCallback(&OnSinkRxAc<false>, &rep->acStats, lat));
   }
+  else if (cfg.metrics & METRIC_LATENCY)
+  {
+    if (cfg.intervalMs > 0)
+      sink->SetRxCallback(MakeBoundCallback(&OnSinkRx<true>, &latency));
+    else
+      sink->SetRxCallback(MakeBoundCallback(&OnSinkRx<false>, &latency));
+  }
+  apNode.Get(0)->AddApplication(sink);
+  sink->SetStartTime(Seconds(0.0));
+  sink->SetStopTime(Seconds(1.0 + simTime + 0.1));
+  rep->sink = sink;
 
-  // ---- Install Poisson UDP apps on STAs (uplink only) ----
+  // ---- Install Poisson / saturated UDP apps on STAs (uplink only) ----
   const Time appStart = Seconds(1.0);
   const Time appStop = Seconds(1.0 + simTime);
+  rep->appStart = appStart;
+  rep->appStop = appStop;
+  const bool saturated = (cfg.trafficModel == "saturated");
+  // --rngStreams=perSta: the Poisson sources of each STA by app slot
+  const bool fixedStreams = (cfg.rngStreams == "perSta");
+  std::vector<std::vector<Ptr<PoissonUdpApp>>> staApps(fixedStreams ? nTotal : 0,
+                                                       std::vector<Ptr<PoissonUdpApp>>(1 + cfg.flows.size()));
 
   for (uint32_t i = 0; i < nTotal; ++i)
   {
     Ptr<Node> sta = allStas.Get(i);
     Ptr<Socket> sock = Socket::CreateSocket(sta, UdpSocketFactory::GetTypeId());
-    Address peer(InetSocketAddress(apIf.GetAddress(0), basePort + i));
+    Address peer(InetSocketAddress(apIf.GetAddress(0), sinkPort));
+
+    if (saturated)
+    {
+      Ptr<WifiNetDevice> dev =
+        DynamicCast<WifiNetDevice>(i < nLegacy ? legacyDevs.Get(i) : heDevs.Get(i - nLegacy));
+      PointerValue txopPv;
+      dev->GetMac()->GetAttribute("BE_Txop", txopPv);
+      Ptr<Txop> txop = txopPv.Get<Txop>();
+      NS_ASSERT(txop && txop->GetWifiMacQueue());
+
+      Ptr<SaturatedUdpApp> app = CreateObject<SaturatedUdpApp>();
+      app->Setup(sock, peer, cfg.payloadSize, cfg.satQueueDepth);
+      app->SetPayloadMode(cfg.payloadMode == "template" ? PayloadMode::TEMPLATE : PayloadMode::ALLOC);
+      txop->GetWifiMacQueue()->TraceConnectWithoutContext(
+        "Dequeue",
+        MakeBoundCallback(&OnSaturatedQueueDequeue, app));
+      txop->GetWifiMacQueue()->TraceConnectWithoutContext(
+        "DropBeforeEnqueue",
+        MakeBoundCallback(&OnSaturatedQueueReject, app));
+      sta->AddApplication(app);
+      app->SetStartTime(appStart);
+      app->SetStopTime(appStop);
+      lambdas[i] = 0.0; // no offered rate
+      continue;
+    }
 
     Ptr<PoissonUdpApp> app = CreateObject<PoissonUdpApp>();
-    app->Setup(sock, peer, payloadSize, lambdas[i]);
+    app->Setup(sock, peer, cfg.payloadSize, lambdas[i]);
+    app->SetPayloadMode(cfg.payloadMode == "template" ? PayloadMode::TEMPLATE : PayloadMode::ALLOC);
+    app->SetArrivalBatch(cfg.arrivalBatch);
     sta->AddApplication(app);
     app->SetStartTime(appStart);
     app->SetStopTime(appStop);
+    if (fixedStreams)
+      staApps[i][0] = app;
+  }
+
+  // Extra flows (--flows): one socket each, whose priority (user priority ->
+  // TID) selects the AC in the STA's MAC. Created after the default flows, so
+  // those draw the same random numbers as without --flows.
+  for (size_t f = 0; f < cfg.flows.size(); ++f)
+  {
+    const FlowSpec& flow = cfg.flows[f];
+    for (uint32_t i = 0; i < nTotal; ++i)
+    {
+      if (!flow.Covers(i, nLegacy))
+        continue;
+      Ptr<Node> sta = allStas.Get(i);
+      Ptr<Socket> sock = Socket::CreateSocket(sta, UdpSocketFactory::GetTypeId());
+      sock->SetPriority(kAcPriority[flow.ac]);
+      Ptr<PoissonUdpApp> app = CreateObject<PoissonUdpApp>();
+      app->Setup(sock, InetSocketAddress(apIf.GetAddress(0), sinkPort), flow.maxSize, flow.lambda);
+      app->SetSizeRange(flow.minSize, flow.maxSize);
+      app->SetOnOff(flow.meanOn, flow.meanOff);
+      app->SetAc(flow.ac);
+      app->SetFlow(static_cast<uint8_t>(std::min<size_t>(1 + f, 255)));
+      app->SetPayloadMode(cfg.payloadMode == "template" ? PayloadMode::TEMPLATE : PayloadMode::ALLOC);
+      app->SetArrivalBatch(cfg.arrivalBatch);
+      sta->AddApplication(app);
+      app->SetStartTime(appStart);
+      app->SetStopTime(appStop);
+      rep->acStats.flows[flow.ac * nTotal + i]++;
+      if (fixedStreams)
+        staApps[i][1 + f] = app;
+    }
+  }
+
+  // ---- Fixed random streams (--rngStreams=perSta, see kStreamsPerBlock) ----
+  if (fixedStreams)
+  {
+    AssignBlockStreams(wifiAp, stack, StreamBlock(cell.bss, 0), apDev.Get(0), apNode.Get(0), {});
+    for (uint32_t i = 0; i < nTotal; ++i)
+    {
+      const bool legacy = i < nLegacy;
+      const uint64_t block = legacy ? 1 + 2 * uint64_t(i) : 2 + 2 * uint64_t(i - nLegacy);
+      AssignBlockStreams(legacy ? wifiLegacy : wifiHe,
+                         stack,
+                         StreamBlock(cell.bss, block),
+                         legacy ? legacyDevs.Get(i) : heDevs.Get(i - nLegacy),
+                         allStas.Get(i),
+                         staApps[i]);
+    }
   }
 
   // ---- Stats: collisions/errors/queue ----
-  std::vector<StaStats> stats(nTotal);
+  StaCounters& stats = rep->stats;
+  stats.Reset(nTotal);
+  rep->measureBase.Reset(nTotal);
+  rep->measureRxBytesBase.assign(nTotal, 0);
+  rep->measureStart = Seconds(0);
+  const bool pollQueue = (cfg.queueSampling == "poll");
+  rep->pollQueue = pollQueue;
+  std::vector<Ptr<WifiMacQueue>>& beQueues = rep->beQueues;
+  beQueues.assign(nTotal, nullptr);
+  rep->staDevices.assign(nTotal, nullptr);
 
   // Hook per-device traces for each STA
   // - collisionsLike: MacTxDataFailed
@@ -450,68 +1894,1310 @@ int main(int argc, char* argv[])
     }
 
     NS_ASSERT(dev);
+    rep->staDevices[i] = dev;
 
-    ns3::Ptr<ns3::WifiRemoteStationManager> rsm = dev->GetRemoteStationManager();
+    // Only the traces of the requested metric groups (--metrics)
+    if (cfg.metrics & METRIC_FAILURES)
+    {
+      ns3::Ptr<ns3::WifiRemoteStationManager> rsm = dev->GetRemoteStationManager();
 
-    rsm->TraceConnectWithoutContext(
-      "MacTxDataFailed",
-      ns3::MakeBoundCallback(&OnMacTxDataFailed, i, &stats));
+      rsm->TraceConnectWithoutContext(
+        "MacTxDataFailed",
+        ns3::MakeBoundCallback(&OnMacTxDataFailed, i, &stats));
 
-    rsm->TraceConnectWithoutContext(
-      "MacTxFinalDataFailed",
-      ns3::MakeBoundCallback(&OnMacTxFinalDataFailed, i, &stats));
+      rsm->TraceConnectWithoutContext(
+        "MacTxFinalDataFailed",
+        ns3::MakeBoundCallback(&OnMacTxFinalDataFailed, i, &stats));
 
-    dev->GetPhy()->TraceConnectWithoutContext(
-      "PhyTxDrop",
-      ns3::MakeBoundCallback(&OnPhyTxDrop, i, &stats));
+      dev->GetPhy()->TraceConnectWithoutContext(
+        "PhyTxDrop",
+        ns3::MakeBoundCallback(&OnPhyTxDrop, i, &stats));
+    }
 
     // Count HE SU vs HE TB uplink frames (HE stations only)
-    if (i >= nLegacy)
+    if (i >= nLegacy && (cfg.metrics & METRIC_TB))
     {
       dev->GetPhy()->TraceConnectWithoutContext(
         "MonitorSnifferTx",
         MakeBoundCallback(&OnHePhyTxMonitor, i, &stats));
     }
 
-    // Queue sampler (BE queue). WifiMac has BE_Txop attribute. :contentReference[oaicite:6]{index=6}
-    Simulator::Schedule(MilliSeconds(1), &SampleQueue, dev, i, &stats);
+    if (cfg.metrics & METRIC_AIRTIME)
+    {
+      dev->GetPhy()->TraceConnectWithoutContext(
+        "PhyTxPsduBegin",
+        MakeBoundCallback(&OnStaPhyTxPsduBegin, i, &stats));
+    }
+    if (cfg.metrics & METRIC_AP)
+    {
+      Ptr<StaWifiMac> staMac = DynamicCast<StaWifiMac>(dev->GetMac());
+      NS_ASSERT(staMac);
+      staMac->TraceConnectWithoutContext("Assoc", MakeBoundCallback(&OnStaAssoc, i, staMac, &rep->ap));
+    }
+
+    // Kept in both sampling modes (the fair MU scheduler reads the backlog)
+    PointerValue txopPv;
+    dev->GetMac()->GetAttribute("BE_Txop", txopPv);
+    Ptr<Txop> txop = txopPv.Get<Txop>();
+    NS_ASSERT(txop && txop->GetWifiMacQueue());
+    beQueues[i] = txop->GetWifiMacQueue();
+    if (!cfg.macQueueMaxSize.empty())
+    {
+      beQueues[i]->SetMaxSize(QueueSize(cfg.macQueueMaxSize));
+      beQueues[i]->TraceConnectWithoutContext("DropBeforeEnqueue",
+                                              MakeBoundCallback(&OnQueueOverflow, &rep->queueOverflows));
+    }
+
+    if (!(cfg.metrics & METRIC_QUEUE))
+    {
+      // No occupancy metric: neither sampler nor queue traces
+    }
+    else if (pollQueue)
+    {
+      // Queue sampler (BE queue). WifiMac has BE_Txop attribute. :contentReference[oaicite:6]{index=6}
+      Simulator::Schedule(MilliSeconds(1), &SampleQueue, dev, i, &stats);
+    }
+    else
+    {
+      stats.queueTraced = true;
+      for (const char* trace : {"Enqueue", "Dequeue", "Drop"})
+      {
+        beQueues[i]->TraceConnectWithoutContext(
+          trace,
+          MakeBoundCallback(&OnBeQueueChange, i, &stats, &beQueues));
+      }
+    }
+
+    // --flows: occupancy of every AC queue that carries traffic
+    AcCounters& acs = rep->acStats;
+    for (uint32_t ac = 0; acs.nSta > 0 && (cfg.metrics & METRIC_QUEUE) && ac < kNumAcs; ++ac)
+    {
+      const uint32_t k = ac * nTotal + i;
+      if (ac != AC_BE && acs.flows[k] == 0)
+        continue;
+      PointerValue acPv;
+      dev->GetMac()->GetAttribute(kAcTxopAttribute[ac], acPv);
+      Ptr<QosTxop> acTxop = acPv.Get<QosTxop>();
+      NS_ASSERT(acTxop && acTxop->GetWifiMacQueue());
+      acs.queues[k] = acTxop->GetWifiMacQueue();
+      if (ac != AC_BE && !cfg.macQueueMaxSize.empty())
+      {
+        acs.queues[k]->SetMaxSize(QueueSize(cfg.macQueueMaxSize));
+        acs.queues[k]->TraceConnectWithoutContext("DropBeforeEnqueue",
+                                                  MakeBoundCallback(&OnQueueOverflow, &rep->queueOverflows));
+      }
+      for (const char* trace : {"Enqueue", "Dequeue", "Drop"})
+      {
+        acs.queues[k]->TraceConnectWithoutContext(trace, MakeBoundCallback(&OnAcQueueChange, k, &acs));
+      }
+    }
   }
 
-  Simulator::Stop(appStop + Seconds(0.2));
-  Simulator::Run();
+  // AP side: trigger frames sent and multi-STA BlockAck outcomes
+  if (cfg.metrics & METRIC_AP)
+  {
+    apWifiDev->GetPhy()->TraceConnectWithoutContext(
+      "PhyTxPsduBegin",
+      MakeBoundCallback(&OnApPhyTxPsduBegin, &rep->ap, &stats));
+  }
+
+  if (Ptr<FairRrMultiUserScheduler> fair = DynamicCast<FairRrMultiUserScheduler>(rep->apMuScheduler))
+  {
+    fair->SetObserver(MakeBoundCallback(&ObserveGroups, static_cast<const Replication*>(rep)));
+    Simulator::Schedule(rep->appStart - Simulator::Now(), &SnapshotAccessRequests, rep);
+  }
+
+  ArmMeasurementWindow(cfg, rep);
+  StartCwControl(cfg, rep);
+}
+
+// ---- Live interval records (--intervalMs) ----
+
+static void IntervalTick(Replication* rep, fairness::RecordStream* out, uint64_t run, Time period);
+
+// Snapshot the counters; the next tick reports the deltas from here.
+static void IntervalRebase(Replication* rep)
+{
+  if (!rep->pollQueue)
+  {
+    for (uint32_t i = 0; i < rep->nTotal; ++i)
+    {
+      AccumulateQueueArea(i, &rep->stats, &rep->beQueues);
+    }
+  }
+  rep->intervalBase = rep->stats;
+  rep->intervalRxBytesBase = rep->sink->GetRxBytes();
+  rep->intervalRxPacketsBase = rep->sink->GetRxPackets();
+  rep->intervalStart = Simulator::Now();
+  for (StaLatency& l : rep->latency)
+  {
+    l.intervalDelayUs.Reset();
+    l.intervalJitterUs.Reset();
+  }
+}
+
+static void IntervalBegin(Replication* rep, fairness::RecordStream* out, uint64_t run, Time period)
+{
+  IntervalRebase(rep);
+  Simulator::Schedule(period, &IntervalTick, rep, out, run, period);
+}
+
+/**
+ * Emit one RECORD_KIND_INTERVAL record per STA with the counter deltas since
+ * the previous tick, then re-arm until appStop. The tick only reads
+ * counters, so the simulated network is the same with or without
+ * --intervalMs (the time-weighted queue integral is merely split into more
+ * segments).
+ */
+static void IntervalTick(Replication* rep, fairness::RecordStream* out, uint64_t run, Time period)
+{
+  const CallbackTimer timer(CB_CONTROL);
+  const double dt = (Simulator::Now() - rep->intervalStart).GetSeconds();
+  const StaCounters& c = rep->stats;
+  const StaCounters& b = rep->intervalBase;
+  const std::vector<uint64_t>& rxBytes = rep->sink->GetRxBytes();
+  const std::vector<uint64_t>& rxPackets = rep->sink->GetRxPackets();
+  rep->intervalIndex++;
+
+  for (uint32_t i = 0; i < rep->nTotal; ++i)
+  {
+    double avgQ = 0.0;
+    if (rep->pollQueue)
+    {
+      const uint64_t n = c.qSamples[i] - b.qSamples[i];
+      avgQ = n > 0 ? static_cast<double>(c.qBytesSum[i] - b.qBytesSum[i]) / n : 0.0;
+    }
+    else
+    {
+      AccumulateQueueArea(i, &rep->stats, &rep->beQueues);
+      avgQ = (c.qByteSeconds[i] - b.qByteSeconds[i]) / dt;
+    }
+
+    const StaLatency& lat = rep->latency[i];
+    fairness::StaRecord r{};
+    r.run = run;
+    r.mu = rep->point.muAccessReqInterval.GetSeconds();
+    r.simTime = dt;
+    r.lambda = rep->lambdas[i];
+    r.rxBytes = rxBytes[i] - rep->intervalRxBytesBase[i];
+    r.throughputMbps = (r.rxBytes * 8.0) / (dt * 1e6);
+    r.avgMacQueue = avgQ;
+    r.collisionsLike = c.collisionsLike[i] - b.collisionsLike[i];
+    r.finalFailures = c.finalFailures[i] - b.finalFailures[i];
+    r.phyTxDrops = c.phyTxDrops[i] - b.phyTxDrops[i];
+    r.heSuTxMpdu = c.heSuTxMpdu[i] - b.heSuTxMpdu[i];
+    r.heTbTxMpdu = c.heTbTxMpdu[i] - b.heTbTxMpdu[i];
+    r.heSuTxBytes = c.heSuTxBytes[i] - b.heSuTxBytes[i];
+    r.heTbTxBytes = c.heTbTxBytes[i] - b.heTbTxBytes[i];
+    r.cwMin = rep->point.apCwMin;
+    r.cwMax = rep->point.apCwMax;
+    r.nLegacy = rep->nLegacy;
+    r.mHe = rep->mHe;
+    r.sta = i;
+    r.type = (i < rep->nLegacy) ? fairness::STA_TYPE_LEGACY : fairness::STA_TYPE_HE;
+    r.rxPackets = rxPackets[i] - rep->intervalRxPacketsBase[i];
+    r.delayP50Us = lat.intervalDelayUs.Percentile(0.50);
+    r.delayP95Us = lat.intervalDelayUs.Percentile(0.95);
+    r.delayP99Us = lat.intervalDelayUs.Percentile(0.99);
+    r.delayMaxUs = static_cast<double>(lat.intervalDelayUs.Max());
+    r.jitterP50Us = lat.intervalJitterUs.Percentile(0.50);
+    r.jitterP99Us = lat.intervalJitterUs.Percentile(0.99);
+    r.bss = rep->bss;
+    r.channel = rep->channelNumber;
+    r.intervalEnd = Simulator::Now().GetSeconds();
+    r.kind = fairness::RECORD_KIND_INTERVAL;
+    r.interval = rep->intervalIndex;
+    r.airtimeSuMs = (c.airtimeSuNs[i] - b.airtimeSuNs[i]) * 1e-6;
+    r.airtimeTbMs = (c.airtimeTbNs[i] - b.airtimeTbNs[i]) * 1e-6;
+    r.airtimeLegacyMs = (c.airtimeLegacyNs[i] - b.airtimeLegacyNs[i]) * 1e-6;
+    r.mstaBaEntries = c.mstaBaEntries[i] - b.mstaBaEntries[i];
+    r.mstaBaAllAck = c.mstaBaAllAck[i] - b.mstaBaAllAck[i];
+    r.seed = RngSeedManager::GetSeed();
+    r.configHash = rep->configHash;
+    out->Add(r);
+  }
+  out->Flush();
+
+  IntervalRebase(rep);
+  if (Simulator::Now() + period <= rep->appStop)
+  {
+    Simulator::Schedule(period, &IntervalTick, rep, out, run, period);
+  }
+}
+
+// Arm the interval reporter of a freshly built replication (no-op when off)
+static void StartIntervalReports(const ScenarioConfig& cfg, Replication* rep, fairness::RecordStream* out,
+                                 uint64_t run)
+{
+  if (!out || cfg.intervalMs == 0)
+    return;
+  rep->intervalIndex = 0;
+  Simulator::Schedule(rep->appStart - Simulator::Now(), &IntervalBegin, rep, out, run,
+                      MilliSeconds(cfg.intervalMs));
+}
+
+// ---- AP-side uplink event capture (--ulTrace) ----
+
+/**
+ * Connect the capture of a built replication to writer (nothing when null).
+ * Without --metrics=ap the STAs' Assoc traces are connected here, for the
+ * AID -> STA map of the trigger user infos.
+ */
+static void StartUlTrace(const ScenarioConfig& cfg, Replication* rep, fairness::UlTraceWriter* writer, uint64_t run)
+{
+  if (!writer)
+    return;
+  UlTraceState& t = rep->ulTrace;
+  t.writer = writer;
+  t.ap = &rep->ap;
+  t.run = static_cast<uint32_t>(run);
+  t.bss = static_cast<uint16_t>(rep->bss);
+  t.configHash = rep->configHash;
+  t.trigger = 0;
+  t.alloc.assign(rep->nTotal, fairness::UlTraceEvent{});
+  t.staByAddress.clear();
+  for (uint32_t i = 0; i < rep->nTotal; ++i)
+  {
+    Ptr<WifiNetDevice> dev = rep->staDevices[i];
+    t.staByAddress[AddressKey(Mac48Address::ConvertFrom(dev->GetAddress()))] = static_cast<uint16_t>(i);
+    if (!(cfg.metrics & METRIC_AP))
+    {
+      Ptr<StaWifiMac> staMac = DynamicCast<StaWifiMac>(dev->GetMac());
+      staMac->TraceConnectWithoutContext("Assoc", MakeBoundCallback(&OnStaAssoc, i, staMac, &rep->ap));
+    }
+  }
+  Ptr<WifiPhy> phy = rep->apDevice->GetPhy();
+  phy->TraceConnectWithoutContext("PhyTxPsduBegin", MakeBoundCallback(&OnUlTraceApTx, &t));
+  phy->TraceConnectWithoutContext("MonitorSnifferRx", MakeBoundCallback(&OnUlTraceApRx, &t));
+  phy->TraceConnectWithoutContext("PhyRxDrop", MakeBoundCallback(&OnUlTraceApRxDrop, &t));
+}
+
+/**
+ * Switch the AP to another sweep point while the simulation is paused
+ * (warm-start mode). Mirrors what BuildReplication sets at construction.
+ */
+static void ApplyPointSettings(Replication* rep, const PointSettings& point)
+{
+  rep->point = point;
+  rep->apBeTxop->SetMinCw(point.apCwMin);
+  rep->apBeTxop->SetMaxCw(point.apCwMax);
+  if (Ptr<FairRrMultiUserScheduler> fair = DynamicCast<FairRrMultiUserScheduler>(rep->apMuScheduler))
+  {
+    // Its controller state would put the warm-up cadence back at the next step.
+    fair->ResetInterval(point.muAccessReqInterval);
+  }
+  else if (rep->apMuScheduler)
+  {
+    // The setter (re)arms the access request timer from Now().
+    rep->apMuScheduler->SetAttribute("AccessReqInterval", TimeValue(point.muAccessReqInterval));
+  }
+  if (rep->cwControl)
+  {
+    ResetCwController(rep);
+  }
+}
+
+/**
+ * Print the result block of a finished replication (and append its records
+ * and histograms). cfg must describe the point that was measured.
+ *
+ * If histFile is set, the full per-STA delay/jitter histograms are appended
+ * to it ("H" lines, one write per replication) for fairness-aggregate.
+ */
+static void ReportReplication(const ScenarioConfig& cfg,
+                              Replication& rep,
+                              uint64_t run,
+                              fairness::RecordWriter* records,
+                              std::FILE* histFile)
+{
+  const uint32_t nLegacy = rep.nLegacy;
+  const uint32_t mHe = rep.mHe;
+  const uint32_t nTotal = rep.nTotal;
+  const double simTime = cfg.simTime;
+  const std::vector<double>& lambdas = rep.lambdas;
+  const std::vector<uint64_t>& sinkRxBytes = rep.sink->GetRxBytes();
+  const std::vector<StaLatency>& latency = rep.latency;
+  const bool pollQueue = rep.pollQueue;
+
+  if (!pollQueue)
+  {
+    // Close the last constant-occupancy segment of every queue integral.
+    for (uint32_t i = 0; i < nTotal; ++i)
+    {
+      AccumulateQueueArea(i, &rep.stats, &rep.beQueues);
+    }
+  }
+  // Counters of the measurement window
+  StaCounters stats = rep.stats;
+  stats.Subtract(rep.measureBase);
+  ApCounters ap = rep.ap;
+  ap.Subtract(rep.measureApBase);
 
   // ---- Print results ----
-  const double measuredInterval = simTime; // seconds
+  const double measuredInterval =
+    rep.windowed ? (rep.appStop - rep.measureStart).GetSeconds() : simTime; // seconds
+  const std::string config = ConfigString(cfg);
+  const uint64_t configHash = ConfigHash(config);
+  char hashHex[17];
+  std::snprintf(hashHex, sizeof(hashHex), "%016llx", static_cast<unsigned long long>(configHash));
   std::cout << "\n=== Results (uplink only) ===\n";
+  std::cout << "Manifest: RngSeed=" << RngSeedManager::GetSeed() << ", RngRun=" << run
+            << ", rngStreams=" << cfg.rngStreams << ", configHash=" << hashHex << ", config=\"" << config
+            << "\"\n";
   std::cout << "nLegacy=" << nLegacy << ", mHe=" << mHe
             << ", channelWidth=20MHz, simTime=" << simTime << "s"
-            << ", apCWmin="<< apCwMin <<", apCWmax=" << apCwMax << "s\n\n";
+            << ", apCWmin="<< cfg.apCwMin <<", apCWmax=" << cfg.apCwMax << "s\n";
+  std::cout << "RngRun=" << run
+            << ", muAccessReqInterval=" << cfg.muAccessReqInterval.GetSeconds() << "s";
+  if (cfg.trafficModel == "saturated")
+  {
+    std::cout << ", trafficModel=saturated, satQueueDepth=" << cfg.satQueueDepth;
+  }
+  if (cfg.phyModel != "spectrum")
+  {
+    std::cout << ", phyModel=" << cfg.phyModel;
+  }
+  if (cfg.nBss > 1)
+  {
+    std::cout << ", bss=" << rep.bss << ", channel=" << unsigned(rep.channelNumber);
+  }
+  if (cfg.metrics != METRIC_ALL)
+  {
+    std::cout << ", metrics=" << cfg.metricsList;
+  }
+  if (rep.windowed)
+  {
+    std::cout << ", warmup=" << (rep.measureStart - rep.appStart).GetSeconds() << "s (" << rep.warmupNote
+              << "), measuredInterval=" << measuredInterval << "s";
+  }
+  std::cout << "\n\n";
+
+  fairness::LatencyHistogram groupDelay[2];
+  fairness::LatencyHistogram groupJitter[2];
+  std::string histLines;
 
   for (uint32_t i = 0; i < nTotal; ++i)
   {
-    const uint64_t rxBytes = sinks[i]->GetTotalRx();
+    const uint64_t rxBytes = sinkRxBytes[i] - rep.measureRxBytesBase[i];
     const double thrMbps = (rxBytes * 8.0) / (measuredInterval * 1e6);
 
-    const double avgQ = (stats[i].qSamples > 0)
-                          ? (static_cast<double>(stats[i].qBytesSum) / stats[i].qSamples)
-                          : 0.0;
+    double avgQ = 0.0;
+    if (pollQueue)
+    {
+      avgQ = (stats.qSamples[i] > 0)
+               ? (static_cast<double>(stats.qBytesSum[i]) / stats.qSamples[i])
+               : 0.0;
+    }
+    else
+    {
+      // Average over [measureStart, now] (measureStart is 0 without a window)
+      avgQ = stats.qByteSeconds[i] / (Simulator::Now() - rep.measureStart).GetSeconds();
+    }
 
     const bool isLegacy = (i < nLegacy);
+    const StaLatency& lat = latency[i];
+    groupDelay[isLegacy ? 0 : 1].Merge(lat.delayUs);
+    groupJitter[isLegacy ? 0 : 1].Merge(lat.jitterUs);
+
     std::cout << "STA[" << i << "] "
               << (isLegacy ? "HT(11ac)" : "HE(11ax)")
               << "  lambda=" << lambdas[i] << " pkt/s"
               << "  throughput=" << thrMbps << " Mbps"
               << "  avgMacQueue=" << avgQ << " B"
-              << "  macTxDataFailed=" << stats[i].collisionsLike
-              << "  macTxFinalDataFailed=" << stats[i].finalFailures
-              << "  phyTxDrop=" << stats[i].phyTxDrops
-              << "  heSuTxMpdu=" << stats[i].heSuTxMpdu
-              << "  heTbTxMpdu=" << stats[i].heTbTxMpdu
-              << "  heSuTxBytes=" << stats[i].heSuTxBytes
-              << "  heTbTxBytes=" << stats[i].heTbTxBytes
+              << "  macTxDataFailed=" << stats.collisionsLike[i]
+              << "  macTxFinalDataFailed=" << stats.finalFailures[i]
+              << "  phyTxDrop=" << stats.phyTxDrops[i]
+              << "  heSuTxMpdu=" << stats.heSuTxMpdu[i]
+              << "  heTbTxMpdu=" << stats.heTbTxMpdu[i]
+              << "  heSuTxBytes=" << stats.heSuTxBytes[i]
+              << "  heTbTxBytes=" << stats.heTbTxBytes[i]
+              << "  airtimeSu=" << stats.airtimeSuNs[i] * 1e-6 << " ms"
+              << "  airtimeTb=" << stats.airtimeTbNs[i] * 1e-6 << " ms"
+              << "  airtimeLegacy=" << stats.airtimeLegacyNs[i] * 1e-6 << " ms"
+              << "  airtimeShare="
+              << (stats.airtimeSuNs[i] + stats.airtimeTbNs[i] + stats.airtimeLegacyNs[i]) * 1e-9 / measuredInterval
+              << "  mstaBaEntries=" << stats.mstaBaEntries[i]
+              << "  mstaBaAllAck=" << stats.mstaBaAllAck[i]
+              << "  delayP50=" << lat.delayUs.Percentile(0.50) << " us"
+              << "  delayP95=" << lat.delayUs.Percentile(0.95) << " us"
+              << "  delayP99=" << lat.delayUs.Percentile(0.99) << " us"
+              << "  delayMax=" << lat.delayUs.Max() << " us"
+              << "  jitterP50=" << lat.jitterUs.Percentile(0.50) << " us"
+              << "  jitterP99=" << lat.jitterUs.Percentile(0.99) << " us"
               << "\n";
+
+    if (histFile)
+    {
+      char prefix[160];
+      std::snprintf(prefix, sizeof(prefix), "H %llu %u %u %.9g %u %u %u %u ",
+                    (unsigned long long)run, nLegacy, mHe, cfg.muAccessReqInterval.GetSeconds(),
+                    cfg.apCwMin, cfg.apCwMax, i,
+                    isLegacy ? fairness::STA_TYPE_LEGACY : fairness::STA_TYPE_HE);
+      histLines += prefix;
+      histLines += "delay " + lat.delayUs.Serialize() + "\n";
+      histLines += prefix;
+      histLines += "jitter " + lat.jitterUs.Serialize() + "\n";
+    }
+
+    if (records)
+    {
+      fairness::StaRecord r{};
+      r.run = run;
+      r.mu = cfg.muAccessReqInterval.GetSeconds();
+      r.simTime = measuredInterval;
+      r.lambda = lambdas[i];
+      r.throughputMbps = thrMbps;
+      r.avgMacQueue = avgQ;
+      r.rxBytes = rxBytes;
+      r.collisionsLike = stats.collisionsLike[i];
+      r.finalFailures = stats.finalFailures[i];
+      r.phyTxDrops = stats.phyTxDrops[i];
+      r.heSuTxMpdu = stats.heSuTxMpdu[i];
+      r.heTbTxMpdu = stats.heTbTxMpdu[i];
+      r.heSuTxBytes = stats.heSuTxBytes[i];
+      r.heTbTxBytes = stats.heTbTxBytes[i];
+      r.cwMin = cfg.apCwMin;
+      r.cwMax = cfg.apCwMax;
+      r.nLegacy = nLegacy;
+      r.mHe = mHe;
+      r.sta = i;
+      r.type = isLegacy ? fairness::STA_TYPE_LEGACY : fairness::STA_TYPE_HE;
+      r.rxPackets = lat.delayUs.Count();
+      r.delayP50Us = lat.delayUs.Percentile(0.50);
+      r.delayP95Us = lat.delayUs.Percentile(0.95);
+      r.delayP99Us = lat.delayUs.Percentile(0.99);
+      r.delayMaxUs = static_cast<double>(lat.delayUs.Max());
+      r.jitterP50Us = lat.jitterUs.Percentile(0.50);
+      r.jitterP99Us = lat.jitterUs.Percentile(0.99);
+      r.bss = rep.bss;
+      r.channel = rep.channelNumber;
+      r.intervalEnd = Simulator::Now().GetSeconds();
+      r.kind = fairness::RECORD_KIND_FINAL;
+      r.airtimeSuMs = stats.airtimeSuNs[i] * 1e-6;
+      r.airtimeTbMs = stats.airtimeTbNs[i] * 1e-6;
+      r.airtimeLegacyMs = stats.airtimeLegacyNs[i] * 1e-6;
+      r.mstaBaEntries = stats.mstaBaEntries[i];
+      r.mstaBaAllAck = stats.mstaBaAllAck[i];
+      r.seed = RngSeedManager::GetSeed();
+      r.configHash = configHash;
+      records->Add(r);
+    }
+  }
+
+  const char* groupName[2] = {"HT(11ac)", "HE(11ax)"};
+  std::cout << "\n";
+  for (int g : {1, 0})
+  {
+    std::cout << "Uplink delay " << groupName[g] << ": p50=" << groupDelay[g].Percentile(0.50)
+              << " us  p95=" << groupDelay[g].Percentile(0.95)
+              << " us  p99=" << groupDelay[g].Percentile(0.99)
+              << " us  max=" << groupDelay[g].Max()
+              << " us  jitterP50=" << groupJitter[g].Percentile(0.50)
+              << " us  jitterP99=" << groupJitter[g].Percentile(0.99) << " us\n";
   }
 
+  // --flows: per AC and group, received rate, delay and mean queue bytes
+  AcCounters& acs = rep.acStats;
+  for (uint32_t ac = 0; ac < kNumAcs && acs.nSta > 0; ++ac)
+  {
+    uint32_t nFlows = 0;
+    double rxMbps[2] = {0.0, 0.0};
+    double qBytes[2] = {0.0, 0.0};
+    uint32_t nQueues[2] = {0, 0};
+    for (uint32_t i = 0; i < nTotal; ++i)
+    {
+      const uint32_t k = ac * nTotal + i;
+      const int g = (i < nLegacy) ? 0 : 1;
+      nFlows += acs.flows[k];
+      rxMbps[g] += acs.rxBytes[k] * 8.0 / (measuredInterval * 1e6);
+      if (acs.queues[k])
+      {
+        acs.AccumulateQueue(k, Simulator::Now());
+        qBytes[g] += acs.qByteSeconds[k] / (Simulator::Now() - rep.measureStart).GetSeconds();
+        nQueues[g]++;
+      }
+    }
+    if (ac != AC_BE && nFlows == 0)
+      continue;
+    std::cout << "AC " << kAcNames[ac] << ": extraFlows=" << nFlows;
+    for (int g : {1, 0})
+    {
+      const fairness::LatencyHistogram& d = acs.delayUs[ac * 2 + g];
+      std::cout << "  " << groupName[g] << " rx=" << rxMbps[g] << " Mbps p50=" << d.Percentile(0.50)
+                << " us p99=" << d.Percentile(0.99) << " us avgMacQueue="
+                << (nQueues[g] ? qBytes[g] / nQueues[g] : 0.0) << " B";
+    }
+    std::cout << "\n";
+  }
+
+  // triggersByNRu as "k:count" for the non-empty bins
+  std::string ruHist;
+  for (uint32_t k = 0; k < ApCounters::kMaxRuBins; ++k)
+  {
+    if (ap.triggersByNRu[k] == 0)
+      continue;
+    ruHist += (ruHist.empty() ? "" : ",") + std::to_string(k) +
+              (k + 1 == ApCounters::kMaxRuBins ? "+" : "") + ":" + std::to_string(ap.triggersByNRu[k]);
+  }
+  std::cout << "AP triggers: basic=" << ap.basicTriggers << "  bsrp=" << ap.bsrpTriggers
+            << "  muBar=" << ap.muBarTriggers << "  other=" << ap.otherTriggers << "  rusPerBasic="
+            << (ap.basicTriggers ? static_cast<double>(ap.rusAllocated) / ap.basicTriggers : 0.0)
+            << "  rusHist=" << (ruHist.empty() ? "-" : ruHist) << "\n";
+  std::cout << "AP BlockAcks: multiSta=" << ap.multiStaBa << "  entries=" << ap.multiStaBaEntries
+            << "  allAck=" << ap.multiStaBaAllAck << "  unknownAid=" << ap.multiStaBaUnknownAid
+            << "  su=" << ap.otherBa << "\n";
+  if (Ptr<FairRrMultiUserScheduler> fair = DynamicCast<FairRrMultiUserScheduler>(rep.apMuScheduler))
+  {
+    std::cout << "MU scheduler: fair  targetJain=" << cfg.fairTargetJain
+              << "  accessReqInterval=" << fair->GetCurrentInterval().GetSeconds() << "s"
+              << "  nStations=" << unsigned(fair->GetCurrentNStations())
+              << "  controlSteps=" << fair->GetControlSteps();
+    // Armed cadence vs what reached the air: basic triggers per second should
+    // follow access requests per second (at most one trigger TXOP each).
+    const double reqs = static_cast<double>(fair->GetAccessRequests() - rep.measureAccessReqBase);
+    std::cout << "  accessReqsPerS=" << reqs / measuredInterval;
+    if (cfg.metrics & METRIC_AP)
+      std::cout << "  basicTriggersPerS=" << ap.basicTriggers / measuredInterval;
+    std::cout << "\n";
+  }
+  if (rep.cwControl)
+  {
+    std::cout << "AP CW controller: pi  targetJain=" << rep.cw.target << "  apCwMin=" << rep.point.apCwMin
+              << "  apCwMax=" << rep.point.apCwMax << "  log2CwMin1=" << rep.cw.u
+              << "  controlSteps=" << rep.cw.steps << "\n";
+  }
+
+  if (cfg.printModel)
+  {
+    // Saturated-uplink model (ul-ofdma-model.h); nominal constants, uncalibrated
+    fairness::ModelParams mp;
+    mp.payloadBytes = cfg.payloadSize;
+    const fairness::ModelResult m = fairness::EvaluatePoint(mp, nLegacy, mHe, cfg.muAccessReqInterval.GetSeconds(),
+                                                            cfg.apCwMin, cfg.apCwMax);
+    std::cout << "Model prediction: thr_total=" << m.thrTotal << " Mbps  HE(11ax)=" << m.thrHeAvg
+              << " Mbps  Legacy(11ac)=" << m.thrLegacyAvg << " Mbps  Jain_group=" << m.jainGroup
+              << "  q=" << m.q << "\n";
+  }
+
+  std::cout.flush();
+  if (records)
+  {
+    records->Flush();
+  }
+  if (histFile && !histLines.empty())
+  {
+    std::fwrite(histLines.data(), 1, histLines.size(), histFile);
+  }
+}
+
+/**
+ * --reportPerf: one "Perf:" line per replication with the setup (topology
+ * and trace hookup) and run wall times, the simulator's event count and the
+ * process's peak RSS so far (scripts/scale_bench.py collects these).
+ */
+static void PrintPerf(const std::vector<std::unique_ptr<Replication>>& cells, double setupWall, double runWall)
+{
+  uint32_t nTotal = 0;
+  uint64_t unknownRx = 0;
+  for (const auto& cell : cells)
+  {
+    nTotal += cell->nTotal;
+    unknownRx += cell->sink->GetUnknownRx();
+  }
+  const uint64_t events = Simulator::GetEventCount();
+  struct rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  std::cout << "Perf: nTotal=" << nTotal << " setupWall=" << setupWall << "s runWall=" << runWall
+            << "s events=" << events << " events/s=" << (runWall > 0 ? events / runWall : 0.0)
+            << " maxRss=" << ru.ru_maxrss << " KB unknownRx=" << unknownRx << "\n";
+  if (g_callbackProfile.enabled)
+  {
+    // Wall time (s) and calls per callback group during Simulator::Run();
+    // the rest of runWall is ns-3 itself (scheduler, PHY, MAC, MU scheduler, apps)
+    double total = 0.0;
+    std::ostringstream groups;
+    for (uint32_t g = 0; g < CB_COUNT; ++g)
+    {
+      const double sec = g_callbackProfile.ns[g] * 1e-9;
+      total += sec;
+      groups << " " << kCallbackGroupNames[g] << "=" << sec << "s/" << g_callbackProfile.calls[g];
+    }
+    std::cout << "Profile: callbacks=" << total << "s ns3=" << std::max(0.0, runWall - total) << "s"
+              << groups.str() << "\n";
+    g_callbackProfile.ns.fill(0);
+    g_callbackProfile.calls.fill(0);
+  }
+  std::cout.flush();
+}
+
+/**
+ * --reportMemory: one "Memory:" line per replication with the process's peak
+ * RSS so far, the events still pending when the run stopped and their peak
+ * during the run (CountingMapScheduler), and the packets the MAC queue cap
+ * turned away.
+ */
+static void PrintMemory(const ScenarioConfig& cfg, const std::vector<std::unique_ptr<Replication>>& cells)
+{
+  uint64_t overflows = 0;
+  for (const auto& cell : cells)
+  {
+    overflows += cell->queueOverflows;
+  }
+  const CountingMapScheduler* scheduler = CountingMapScheduler::GetCurrent();
+  struct rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  std::cout << "Memory: maxRss=" << ru.ru_maxrss << " KB pendingEvents=" << (scheduler ? scheduler->GetSize() : 0)
+            << " peakPendingEvents=" << (scheduler ? scheduler->GetPeakSize() : 0)
+            << " macQueueMaxSize=" << (cfg.macQueueMaxSize.empty() ? "default" : cfg.macQueueMaxSize)
+            << " queueOverflows=" << overflows << "\n";
+  std::cout.flush();
+}
+
+/**
+ * The cells of the floor that this rank simulates. Cells sharing a channel
+ * interact and are never split; channel group g goes to rank g % mpiSize.
+ * Every rank gets one spectrum channel per channel it simulates; with more
+ * than one BSS the channels carry log-distance loss so that spacing matters.
+ */
+static std::vector<CellLayout> LocalCells(const ScenarioConfig& cfg)
+{
+  const uint32_t reuse = cfg.channelReuse;
+  const uint32_t cols = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(cfg.nBss))));
+  std::vector<Ptr<MultiModelSpectrumChannel>> channels(reuse);
+  std::vector<CellLayout> out;
+  for (uint32_t b = 0; b < cfg.nBss; ++b)
+  {
+    const uint32_t group = b % reuse;
+    if (group % cfg.mpiSize != cfg.mpiRank)
+      continue;
+
+    CellLayout cell;
+    cell.bss = b;
+    cell.systemId = cfg.mpiRank;
+    cell.channelNumber = kBssChannels[group];
+    cell.center = Vector((b % cols) * cfg.bssSpacing, (b / cols) * cfg.bssSpacing, 0.0);
+    if (cfg.nBss > 1)
+    {
+      if (!channels[group])
+      {
+        channels[group] = CreateObject<MultiModelSpectrumChannel>();
+        channels[group]->AddPropagationLossModel(CreateObject<LogDistancePropagationLossModel>());
+        channels[group]->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+      }
+      cell.channel = channels[group];
+    }
+    out.push_back(cell);
+  }
+  return out;
+}
+
+/**
+ * Build the topology (this rank's cells of the floor with --nBss), run one
+ * replication with the current RngRun and print one result block per cell.
+ * The simulator is destroyed on return so that the caller
+ * can start the next replication from a clean state.
+ */
+static void RunReplication(const ScenarioConfig& cfg,
+                           uint64_t run,
+                           fairness::RecordWriter* records,
+                           std::FILE* histFile,
+                           fairness::RecordStream* intervals,
+                           fairness::UlTraceWriter* ulTrace)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  if (cfg.reportMemory)
+  {
+    // Same event order as the default MapScheduler, plus a pending count
+    Simulator::SetScheduler(ObjectFactory("ns3::CountingMapScheduler"));
+  }
+  std::vector<std::unique_ptr<Replication>> cells;
+  for (const CellLayout& layout : LocalCells(cfg))
+  {
+    cells.push_back(std::make_unique<Replication>());
+    BuildReplication(cfg, layout, cells.back().get());
+    StartIntervalReports(cfg, cells.back().get(), intervals, run);
+    StartUlTrace(cfg, cells.back().get(), ulTrace, run);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  // Setup-time callbacks (none expected) do not count towards the run
+  g_callbackProfile.ns.fill(0);
+  g_callbackProfile.calls.fill(0);
+
+  // Same stop time on every rank (a rank may own no cell at all)
+  Simulator::Stop(Seconds(1.0 + cfg.simTime + 0.2));
+  Simulator::Run();
+  const auto t2 = std::chrono::steady_clock::now();
+
+  for (const auto& cell : cells)
+  {
+    ReportReplication(cfg, *cell, run, records, histFile);
+  }
+  if (cfg.reportPerf)
+  {
+    PrintPerf(cells, std::chrono::duration<double>(t1 - t0).count(), std::chrono::duration<double>(t2 - t1).count());
+  }
+  if (cfg.reportMemory)
+  {
+    PrintMemory(cfg, cells);
+  }
+  if (ulTrace)
+  {
+    ulTrace->Flush();
+  }
   Simulator::Destroy();
+}
+
+// cfg with the settings of one warm-start point
+static ScenarioConfig PointConfig(const ScenarioConfig& cfg, const PointSettings& point)
+{
+  ScenarioConfig pointCfg = cfg;
+  pointCfg.muAccessReqInterval = point.muAccessReqInterval;
+  pointCfg.apCwMin = point.apCwMin;
+  pointCfg.apCwMax = point.apCwMax;
+  return pointCfg;
+}
+
+// Run the paused simulation of one warm-start point to the end and report it.
+static void FinishPoint(const ScenarioConfig& cfg,
+                        Replication& rep,
+                        const PointSettings& point,
+                        uint64_t run,
+                        fairness::RecordWriter* records,
+                        std::FILE* histFile,
+                        fairness::UlTraceWriter* ulTrace)
+{
+  const ScenarioConfig pointCfg = PointConfig(cfg, point);
+
+  ApplyPointSettings(&rep, point);
+  rep.configHash = ConfigHash(ConfigString(pointCfg)); // labels the point's interval records
+  rep.ulTrace.configHash = rep.configHash;             // and uplink trace events
+  Simulator::Stop(rep.appStop + Seconds(0.2) - Simulator::Now());
+  Simulator::Run();
+  ReportReplication(pointCfg, rep, run, records, histFile);
+  if (ulTrace)
+  {
+    ulTrace->Flush();
+  }
+}
+
+/**
+ * Warm-start mode: simulate association, ARP and everything else before
+ * appStart once with the base cfg, then measure every point from that state.
+ *
+ * With fork=true the process forks at appStart and each child (one at a
+ * time, so output order is deterministic) applies its point settings,
+ * finishes the run and exits; the parent keeps the pristine paused state
+ * for the next point. With fork=false every point rebuilds and re-runs the
+ * identical warm-up instead; both paths execute the same events, so their
+ * outputs must match exactly (this is the determinism check of the mode).
+ */
+static void RunWarmStart(const ScenarioConfig& cfg,
+                         const std::vector<PointSettings>& points,
+                         bool fork,
+                         uint64_t run,
+                         fairness::RecordWriter* records,
+                         std::FILE* histFile,
+                         fairness::RecordStream* intervals,
+                         fairness::UlTraceWriter* ulTrace)
+{
+  if (!fork)
+  {
+    for (const PointSettings& point : points)
+    {
+      RngSeedManager::SetRun(run);
+      RngSeedManager::ResetNextStreamIndex();
+      Ipv4AddressGenerator::Reset();
+
+      Replication rep;
+      BuildReplication(cfg, CellLayout{}, &rep);
+      StartIntervalReports(cfg, &rep, intervals, run);
+      StartUlTrace(cfg, &rep, ulTrace, run);
+      // Each point repeats the warm-up: its trace events belong to the point.
+      rep.ulTrace.configHash = ConfigHash(ConfigString(PointConfig(cfg, point)));
+      Simulator::Stop(rep.appStart);
+      Simulator::Run();
+      FinishPoint(cfg, rep, point, run, records, histFile, ulTrace);
+      Simulator::Destroy();
+    }
+    return;
+  }
+
+  Replication rep;
+  BuildReplication(cfg, CellLayout{}, &rep);
+  StartIntervalReports(cfg, &rep, intervals, run);
+  StartUlTrace(cfg, &rep, ulTrace, run);
+  Simulator::Stop(rep.appStart);
+  Simulator::Run();
+
+  for (const PointSettings& point : points)
+  {
+    // Nothing buffered may be duplicated into the child.
+    std::cout.flush();
+    std::fflush(nullptr);
+    if (records)
+    {
+      records->Flush();
+    }
+    if (ulTrace)
+    {
+      ulTrace->Flush(); // the warm-up's events, written once
+    }
+
+    const pid_t pid = ::fork();
+    NS_ABORT_MSG_IF(pid < 0, "fork() failed: " << std::strerror(errno));
+    if (pid == 0)
+    {
+      FinishPoint(cfg, rep, point, run, records, histFile, ulTrace);
+      std::cout.flush();
+      std::fflush(nullptr);
+      if (intervals)
+      {
+        intervals->Close(); // last non-blocking attempt at queued interval records
+      }
+      // Skip atexit handlers and static destructors of the parent's state.
+      _exit(0);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0,
+                    "Warm-start child for apCwMin=" << point.apCwMin << " apCwMax=" << point.apCwMax
+                                                    << " mu=" << point.muAccessReqInterval.GetSeconds()
+                                                    << "s failed");
+  }
+
+  Simulator::Destroy();
+}
+
+// "mu:cwmin:cwmax,..." (mu in seconds), e.g. "0.01:15:1023,0.01:7:63"
+static std::vector<PointSettings> ParsePoints(const std::string& s)
+{
+  std::vector<PointSettings> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    if (item.empty())
+      continue;
+    double mu = 0.0;
+    unsigned cwMin = 0;
+    unsigned cwMax = 0;
+    NS_ABORT_MSG_IF(std::sscanf(item.c_str(), "%lf:%u:%u", &mu, &cwMin, &cwMax) != 3,
+                    "Bad --warmStartPoints entry '" << item << "' (expected mu:cwmin:cwmax)");
+    out.push_back(PointSettings{Seconds(mu), cwMin, cwMax});
+  }
+  return out;
+}
+
+// Checks the run settings and derives the ones computed from them
+// (metric mask, --reportPerf implied by --profileCallbacks, channel groups).
+static void ValidateConfig(ScenarioConfig& cfg)
+{
+  NS_ABORT_MSG_IF(cfg.queueSampling != "trace" && cfg.queueSampling != "poll",
+                  "Unknown --queueSampling=" << cfg.queueSampling << " (expected trace or poll)");
+  NS_ABORT_MSG_IF(cfg.trafficModel != "poisson" && cfg.trafficModel != "saturated",
+                  "Unknown --trafficModel=" << cfg.trafficModel << " (expected poisson or saturated)");
+  NS_ABORT_MSG_IF(cfg.payloadMode != "alloc" && cfg.payloadMode != "template",
+                  "Unknown --payloadMode=" << cfg.payloadMode << " (expected alloc or template)");
+  NS_ABORT_MSG_IF(cfg.phyModel != "spectrum" && cfg.phyModel != "abstract",
+                  "Unknown --phyModel=" << cfg.phyModel << " (expected spectrum or abstract)");
+  NS_ABORT_MSG_IF(cfg.abstractSnrStepDb < 1e-3 || cfg.abstractSnrStepDb > 3.0, "--abstractSnrStepDb must be in [0.001, 3]");
+  NS_ABORT_MSG_IF(cfg.muScheduler != "rr" && cfg.muScheduler != "fair",
+                  "Unknown --muScheduler=" << cfg.muScheduler << " (expected rr or fair)");
+  NS_ABORT_MSG_IF(cfg.fairTargetJain < 0.5 || cfg.fairTargetJain > 1.0, "--fairTargetJain must be in [0.5, 1]");
+  NS_ABORT_MSG_IF(!cfg.fairControlInterval.IsStrictlyPositive(), "--fairControlInterval must be > 0");
+  uint32_t metrics = 0;
+  NS_ABORT_MSG_IF(!ParseMetrics(cfg.metricsList, &metrics),
+                  "Unknown --metrics=" << cfg.metricsList
+                                       << " (expected all or throughput,queue,failures,tb,airtime,ap,latency)");
+  if (metrics == METRIC_ALL)
+    metrics = kCompiledMetrics;
+  NS_ABORT_MSG_IF(metrics & ~kCompiledMetrics,
+                  "--metrics=" << cfg.metricsList << " asks for groups compiled out by FAIRNESS_METRICS");
+  cfg.metrics = metrics;
+  NS_ABORT_MSG_IF(cfg.cwControl != "off" && cfg.cwControl != "pi",
+                  "Unknown --cwControl=" << cfg.cwControl << " (expected off or pi)");
+  NS_ABORT_MSG_IF(cfg.cwControl == "pi" && (cfg.nLegacy == 0 || cfg.mHe == 0),
+                  "--cwControl=pi needs both legacy and HE stations");
+  NS_ABORT_MSG_IF(cfg.cwTargetJain < 0.5 || cfg.cwTargetJain > 1.0, "--cwTargetJain must be in [0.5, 1]");
+  NS_ABORT_MSG_IF(!cfg.cwControlInterval.IsStrictlyPositive() || cfg.cwKp < 0.0 || cfg.cwKi < 0.0,
+                  "--cwControlInterval must be > 0 and --cwKp/--cwKi >= 0");
+  NS_ABORT_MSG_IF(cfg.placement != "line" && cfg.placement != "disc",
+                  "Unknown --placement=" << cfg.placement << " (expected line or disc)");
+  NS_ABORT_MSG_IF(cfg.placement == "disc" && cfg.placementRadius < 0.5,
+                  "--placementRadius must be at least 0.5 m");
+  NS_ABORT_MSG_IF(cfg.warmupMode != "fixed" && cfg.warmupMode != "mser",
+                  "Unknown --warmupMode=" << cfg.warmupMode << " (expected fixed or mser)");
+  NS_ABORT_MSG_IF(cfg.warmup < 0.0 || cfg.warmup >= cfg.simTime, "--warmup must be in [0, simTime)");
+  NS_ABORT_MSG_IF(cfg.warmupMode == "mser" && (cfg.warmupSampleMs == 0 || cfg.warmupMax >= cfg.simTime),
+                  "--warmupSampleMs must be > 0 and --warmupMax < simTime");
+  cfg.reportPerf = cfg.reportPerf || g_callbackProfile.enabled;
+  std::string badFlow;
+  NS_ABORT_MSG_IF(!ParseFlows(cfg.flowsList, &cfg.flows, &badFlow),
+                  "Bad --flows entry '" << badFlow << "' (expected who:ac:size:lambda[:onMs:offMs])");
+  for (const FlowSpec& flow : cfg.flows)
+  {
+    NS_ABORT_MSG_IF(flow.who == FlowSpec::RANGE && flow.last >= cfg.nLegacy + cfg.mHe,
+                    "--flows: STA index " << flow.last << " out of range (nLegacy + mHe = "
+                                          << cfg.nLegacy + cfg.mHe << ")");
+  }
+  if (cfg.longRun)
+  {
+    cfg.macQueueMaxSize = cfg.macQueueMaxSize.empty() ? "100p" : cfg.macQueueMaxSize;
+    cfg.reportMemory = true;
+  }
+  if (!cfg.macQueueMaxSize.empty())
+  {
+    const QueueSize cap(cfg.macQueueMaxSize); // aborts on a malformed size
+    NS_ABORT_MSG_IF(cap.GetValue() == 0, "--macQueueMaxSize must be > 0");
+    NS_ABORT_MSG_IF(cfg.trafficModel == "saturated" && cap.GetUnit() == QueueSizeUnit::PACKETS &&
+                      cap.GetValue() < cfg.satQueueDepth,
+                    "--macQueueMaxSize=" << cfg.macQueueMaxSize << " is below --satQueueDepth=" << cfg.satQueueDepth);
+  }
+  NS_ABORT_MSG_IF(cfg.nBss < 1 || cfg.nBss > 254, "--nBss must be in [1, 254]");
+  NS_ABORT_MSG_IF(cfg.channelReuse < 1 || cfg.channelReuse > sizeof(kBssChannels),
+                  "--channelReuse must be in [1, " << sizeof(kBssChannels) << "]");
+  cfg.channelReuse = std::min(cfg.channelReuse, cfg.nBss);
+  NS_ABORT_MSG_IF(cfg.rngStreams != "auto" && cfg.rngStreams != "perSta",
+                  "Unknown --rngStreams=" << cfg.rngStreams << " (expected auto or perSta)");
+  NS_ABORT_MSG_IF(cfg.rngStreams == "perSta" && 1 + cfg.flows.size() > kMaxAppSlots,
+                  "--rngStreams=perSta supports at most " << kMaxAppSlots - 1 << " --flows entries");
+}
+
+// RngRuns of --runFirst/--runLast (runFirst < 0: the current --RngRun only)
+static std::vector<uint64_t> RunRange(int64_t runFirst, int64_t runLast)
+{
+  if (runFirst < 0)
+    return {RngSeedManager::GetRun()};
+  std::vector<uint64_t> runs;
+  for (int64_t run = runFirst; run <= std::max(runFirst, runLast); ++run)
+    runs.push_back(static_cast<uint64_t>(run));
+  return runs;
+}
+
+/**
+ * Simulates one configuration per RngRun in runs, each run printing its own
+ * result block. resetGlobals restores, before every run, the global state a
+ * fresh process starts with; it is needed whenever the process simulates more
+ * than once.
+ */
+static void RunReplications(const ScenarioConfig& cfg,
+                            const std::vector<uint64_t>& runs,
+                            bool resetGlobals,
+                            const std::vector<PointSettings>& points,
+                            bool warmStartFork,
+                            fairness::RecordWriter* records,
+                            std::FILE* histFile,
+                            fairness::RecordStream* intervals,
+                            fairness::UlTraceWriter* ulTrace)
+{
+  for (uint64_t run : runs)
+  {
+    if (resetGlobals)
+    {
+      // Every replication must see the same global state a fresh process
+      // would: same RNG stream numbering and an empty IPv4 address pool.
+      RngSeedManager::SetRun(run);
+      RngSeedManager::ResetNextStreamIndex();
+      Ipv4AddressGenerator::Reset();
+    }
+
+    if (points.empty())
+      RunReplication(cfg, run, records, histFile, intervals, ulTrace);
+    else
+      RunWarmStart(cfg, points, warmStartFork, run, records, histFile, intervals, ulTrace);
+  }
+}
+
+// Options a --scenarioFile entry must not set: the outputs are opened once for
+// the whole file, and ns-3 global values would leak into the later entries.
+static bool IsProcessOption(const std::string& key)
+{
+  static const char* const kKeys[] = {"outFormat", "outFile", "histFile", "intervalMs", "intervalOut",
+                                      "intervalFormat", "ulTrace", "ulTraceLast", "mpi", "scenarioFile",
+                                      "RngRun"};
+  for (const char* k : kKeys)
+  {
+    if (key == k)
+      return true;
+  }
+  if (key.find("::") != std::string::npos)
+    return true;
+  for (auto it = GlobalValue::Begin(); it != GlobalValue::End(); ++it)
+  {
+    if ((*it)->GetName() == key)
+      return true;
+  }
+  return false;
+}
+
+int main(int argc, char* argv[])
+{
+  ScenarioConfig cfg;
+
+  // Replication range. runFirst < 0 keeps the single-run behaviour driven by
+  // --RngRun; otherwise every run in [runFirst, runLast] is simulated in this
+  // process, each one printing its own result block.
+  int64_t runFirst = -1;
+  int64_t runLast = -1;
+
+  // Optional machine-readable output, written in addition to the text log
+  std::string outFormat = "text";
+  std::string outFile = "";
+  std::string histFileName = "";
+
+  // Live interval records (opt-in)
+  std::string intervalOut = "";
+  std::string intervalFormat = "csv";
+
+  // Warm-start mode (opt-in): measure several (mu, AP CW) points from one
+  // shared warm-up per RngRun
+  std::string warmStartPoints = "";
+  bool warmStartFork = true;
+
+  // Scenario file (opt-in): a list of runs, each one the command line above
+  // plus its own options, executed back to back with shared outputs
+  std::string scenarioFile = "";
+
+  // AP-side uplink event capture (opt-in, see ul-trace.h)
+  std::string ulTraceFile = "";
+  uint32_t ulTraceLast = 0;
+
+  CommandLine cmd(__FILE__);
+  cmd.AddValue("nLegacy", "Number of 802.11ac (HT) stations", cfg.nLegacy);
+  cmd.AddValue("mHe", "Number of 802.11ax (HE) stations", cfg.mHe);
+  cmd.AddValue("simTime", "Simulation time (s) after apps start", cfg.simTime);
+  cmd.AddValue("payloadSize", "UDP payload size (bytes)", cfg.payloadSize);
+  cmd.AddValue("payloadMode", "Uplink packet construction: alloc (new packet each send) or template (copy-on-write copy)", cfg.payloadMode);
+  cmd.AddValue("trafficModel", "Uplink traffic: poisson (lambda per STA) or saturated (BE queue kept at satQueueDepth)", cfg.trafficModel);
+  cmd.AddValue("flows", "Extra uplink flows: who:ac:size:lambda[:onMs:offMs],... (who all|legacy|he|i|i-j, ac be|bk|vi|vo, size N or min-max bytes; on/off: mean burst and gap)", cfg.flowsList);
+  cmd.AddValue("satQueueDepth", "Saturated mode: own packets kept in each STA's BE MAC queue", cfg.satQueueDepth);
+  cmd.AddValue("arrivalBatch", "Poisson inter-arrival times drawn per RNG pass (same sequence for any value)", cfg.arrivalBatch);
+  cmd.AddValue("lambdaList", "Comma-separated lambdas (pkts/s) per station (legacy first, then HE)", cfg.lambdaListCsv);
+  cmd.AddValue("lambdaLegacy", "Default lambda (pkts/s) for legacy STAs if lambdaList is empty", cfg.lambdaLegacy);
+  cmd.AddValue("lambdaHe", "Default lambda (pkts/s) for HE STAs if lambdaList is empty", cfg.lambdaHe);
+  cmd.AddValue("apCwMin", "AP BE CWmin (DCF)", cfg.apCwMin);
+  cmd.AddValue("apCwMax", "AP BE CWmax (DCF)", cfg.apCwMax);
+  cmd.AddValue("enableUlOfdma", "Enable UL OFDMA in MU scheduler", cfg.enableUlOfdma);
+  cmd.AddValue("muAccessReqInterval", "MU scheduler access request interval (e.g., 0ms, 2ms)", cfg.muAccessReqInterval);
+  cmd.AddValue("muScheduler", "AP MU scheduler: rr (round robin) or fair (adapts access request interval and RUs per trigger to --fairTargetJain)", cfg.muScheduler);
+  cmd.AddValue("fairTargetJain", "Fair MU scheduler: HE vs legacy Jain index to maintain (0.5..1)", cfg.fairTargetJain);
+  cmd.AddValue("fairControlInterval", "Fair MU scheduler: controller period", cfg.fairControlInterval);
+  cmd.AddValue("cwControl", "AP CW: off (fixed --apCwMin/--apCwMax) or pi (retuned online towards --cwTargetJain, starting from them)", cfg.cwControl);
+  cmd.AddValue("cwTargetJain", "CW controller: Jain_group target eta (0.5..1)", cfg.cwTargetJain);
+  cmd.AddValue("cwControlInterval", "CW controller: period", cfg.cwControlInterval);
+  cmd.AddValue("cwKp", "CW controller: proportional gain (octaves of CWmin+1 per unit of Jain error)", cfg.cwKp);
+  cmd.AddValue("cwKi", "CW controller: integral gain (octaves per unit of Jain error and second)", cfg.cwKi);
+  cmd.AddValue("metrics", "Metric groups to collect: all, or a list of throughput (always), queue, failures, tb, airtime, ap, latency", cfg.metricsList);
+  cmd.AddValue("phyModel", "PHY error model: spectrum (full error model per chunk) or abstract (error model cached per quantised link SNR; PSD interference unchanged)", cfg.phyModel);
+  cmd.AddValue("abstractSnrStepDb", "Abstract PHY: SNR quantisation step (dB) of the error model cache", cfg.abstractSnrStepDb);
+  cmd.AddValue("queueSampling", "BE queue occupancy metric: trace (time-weighted, event-driven) or poll (1 ms sampler)", cfg.queueSampling);
+  cmd.AddValue("placement", "STA placement: line (1 m + 0.1 m per STA) or disc (spread over --placementRadius)", cfg.placement);
+  cmd.AddValue("placementRadius", "Disc placement: radius (m) around the AP", cfg.placementRadius);
+  cmd.AddValue("reportPerf", "Print setup/run wall time, event count and peak RSS after each replication", cfg.reportPerf);
+  cmd.AddValue("macQueueMaxSize", "Cap of every STA's BE MAC queue, e.g. 64p or 100000B (empty: WifiMacQueue default)", cfg.macQueueMaxSize);
+  cmd.AddValue("reportMemory", "Print peak RSS, pending/peak simulator events and MAC queue overflows after each replication", cfg.reportMemory);
+  cmd.AddValue("longRun", "Memory-bounded long runs: --macQueueMaxSize=100p unless given, and --reportMemory", cfg.longRun);
+  cmd.AddValue("profileCallbacks", "Time the scenario's trace callbacks per group and print a Profile: line (implies --reportPerf)", g_callbackProfile.enabled);
+  cmd.AddValue("nBss", "Number of BSSs (AP + nLegacy + mHe STAs each) on a square grid", cfg.nBss);
+  cmd.AddValue("bssSpacing", "Multi-BSS: distance (m) between neighbouring APs", cfg.bssSpacing);
+  cmd.AddValue("channelReuse", "Multi-BSS: number of non-overlapping 20 MHz channels cells cycle through (1: all co-channel, max 8)", cfg.channelReuse);
+  cmd.AddValue("mpi", "Multi-BSS: distribute channel groups over MPI ranks (ns-3 built with --enable-mpi, run under mpirun)", cfg.mpi);
+  cmd.AddValue("printModel", "Print the analytical model prediction (ul-ofdma-model.h) after each result block", cfg.printModel);
+  cmd.AddValue("runFirst", "First RngRun of an in-process replication range (-1: use --RngRun only)", runFirst);
+  cmd.AddValue("runLast", "Last RngRun of the replication range (inclusive; -1: same as runFirst)", runLast);
+  cmd.AddValue("rngStreams", "Random stream numbering: auto (ns-3 creation order) or perSta (fixed per-STA blocks, stable when STAs are added)", cfg.rngStreams);
+  cmd.AddValue("outFormat", "Extra per-STA record output: text (none), csv or binary", outFormat);
+  cmd.AddValue("outFile", "File the csv/binary records are appended to", outFile);
+  cmd.AddValue("histFile", "File the per-STA delay/jitter histograms are appended to (for fairness-aggregate)", histFileName);
+  cmd.AddValue("warmupMode", "Measurement window start: fixed (--warmup s after appStart) or mser (online MSER-5 detection)", cfg.warmupMode);
+  cmd.AddValue("warmup", "Fixed warm-up (s) excluded from all metrics (0: measure from appStart)", cfg.warmup);
+  cmd.AddValue("warmupSampleMs", "MSER warm-up detection: observation period (ms)", cfg.warmupSampleMs);
+  cmd.AddValue("warmupMax", "MSER warm-up detection: latest window start (s after appStart; < 0: simTime/2)", cfg.warmupMax);
+  cmd.AddValue("intervalMs", "Emit per-STA interval records (deltas) every N ms of simulated time (0: off)", cfg.intervalMs);
+  cmd.AddValue("intervalOut", "Interval record target: file, FIFO or udp:HOST:PORT (writes never block)", intervalOut);
+  cmd.AddValue("intervalFormat", "Interval record encoding: csv or binary", intervalFormat);
+  cmd.AddValue("warmStartPoints", "Warm-start mode: points mu:cwmin:cwmax,... measured from one shared warm-up (base settings until appStart)", warmStartPoints);
+  cmd.AddValue("warmStartFork", "Warm-start mode: fork at appStart (true) or rebuild and re-run the warm-up per point (false, reference)", warmStartFork);
+  cmd.AddValue("scenarioFile", "JSON list of runs (option overrides, seeds) executed back to back in this process (scenario-file.h)", scenarioFile);
+  cmd.AddValue("ulTrace", "File the AP-side trigger/RU/MPDU event capture is appended to (binary, read with ul-trace-reader)", ulTraceFile);
+  cmd.AddValue("ulTraceLast", "Uplink event capture: keep only the last N events of each run (0: all)", ulTraceLast);
+  cmd.Parse(argc, argv);
+
+  // Every scenario file entry starts from the command line as given
+  const ScenarioConfig baseCfg = cfg;
+  const int64_t baseRunFirst = runFirst;
+  const int64_t baseRunLast = runLast;
+  const std::string baseWarmStartPoints = warmStartPoints;
+  const bool baseWarmStartFork = warmStartFork;
+  const bool baseProfile = g_callbackProfile.enabled;
+
+  ValidateConfig(cfg);
+
+  if (cfg.mpi)
+  {
+#ifdef NS3_MPI
+    // Cells on different channels exchange no events, so the lookahead is
+    // unbounded and ranks only synchronise at the end of each run.
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+    cfg.mpiRank = MpiInterface::GetSystemId();
+    cfg.mpiSize = MpiInterface::GetSize();
+    if (cfg.mpiRank == 0 && cfg.mpiSize > cfg.channelReuse)
+    {
+      std::cerr << "Warning: " << cfg.mpiSize << " MPI ranks for " << cfg.channelReuse
+                << " channel groups; ranks >= " << cfg.channelReuse << " stay idle\n";
+    }
+    if (cfg.mpiSize > 1)
+    {
+      // One file per rank: ranks run concurrently and must not share outputs.
+      const std::string suffix = ".rank" + std::to_string(cfg.mpiRank);
+      if (!outFile.empty())
+        outFile += suffix;
+      if (!histFileName.empty())
+        histFileName += suffix;
+      if (!intervalOut.empty() && intervalOut.compare(0, 4, "udp:") != 0)
+        intervalOut += suffix;
+      if (!ulTraceFile.empty())
+        ulTraceFile += suffix;
+    }
+#else
+    NS_ABORT_MSG("--mpi=true requires ns-3 configured with --enable-mpi");
+#endif
+  }
+
+  fairness::RecordWriter recordWriter;
+  fairness::RecordWriter* records = nullptr;
+  if (outFormat != "text")
+  {
+    NS_ABORT_MSG_IF(outFormat != "csv" && outFormat != "binary",
+                    "Unknown --outFormat=" << outFormat << " (expected text, csv or binary)");
+    NS_ABORT_MSG_IF(outFile.empty(), "--outFormat=" << outFormat << " requires --outFile");
+    const bool ok = recordWriter.Open(outFile,
+                                      outFormat == "csv" ? fairness::RecordFormat::CSV
+                                                         : fairness::RecordFormat::BINARY);
+    NS_ABORT_MSG_IF(!ok, "Cannot open --outFile=" << outFile << " (or it holds records of another schema version)");
+    records = &recordWriter;
+  }
+
+  std::FILE* histFile = nullptr;
+  if (!histFileName.empty())
+  {
+    histFile = std::fopen(histFileName.c_str(), "a");
+    NS_ABORT_MSG_IF(!histFile, "Cannot open --histFile=" << histFileName);
+    // Unbuffered, like the record writer: one append per replication.
+    std::setvbuf(histFile, nullptr, _IONBF, 0);
+  }
+
+  fairness::RecordStream intervalStream;
+  fairness::RecordStream* intervals = nullptr;
+  if (cfg.intervalMs > 0)
+  {
+    NS_ABORT_MSG_IF(intervalFormat != "csv" && intervalFormat != "binary",
+                    "Unknown --intervalFormat=" << intervalFormat << " (expected csv or binary)");
+    NS_ABORT_MSG_IF(intervalOut.empty(), "--intervalMs requires --intervalOut");
+    const bool ok = intervalStream.Open(intervalOut,
+                                        intervalFormat == "csv" ? fairness::RecordFormat::CSV
+                                                                : fairness::RecordFormat::BINARY);
+    NS_ABORT_MSG_IF(!ok, "Cannot open --intervalOut=" << intervalOut
+                                            << " (or it holds records of another schema version)");
+    intervals = &intervalStream;
+  }
+
+  fairness::UlTraceWriter ulTraceWriter;
+  fairness::UlTraceWriter* ulTrace = nullptr;
+  if (!ulTraceFile.empty())
+  {
+    const bool ok = ulTraceWriter.Open(ulTraceFile, ulTraceLast);
+    NS_ABORT_MSG_IF(!ok, "Cannot open --ulTrace=" << ulTraceFile << " (or it holds events of another version)");
+    ulTrace = &ulTraceWriter;
+  }
+
+  if (scenarioFile.empty())
+  {
+    const std::vector<PointSettings> points = ParsePoints(warmStartPoints);
+    NS_ABORT_MSG_IF(!points.empty() && cfg.nBss > 1, "--warmStartPoints supports a single BSS only");
+    // A single run keeps the process state as it is (it is the first one)
+    RunReplications(cfg, RunRange(runFirst, runLast), runFirst >= 0, points, warmStartFork, records, histFile,
+                    intervals, ulTrace);
+  }
+  else
+  {
+    std::vector<fairness::ScenarioRun> entries;
+    std::string error;
+    NS_ABORT_MSG_IF(!fairness::LoadScenarioFile(scenarioFile, &entries, &error),
+                    "--scenarioFile=" << scenarioFile << ": " << error);
+
+    // Parse and check every entry before simulating any of them, so that a
+    // typo in the last entry does not cost the runs before it.
+    struct Entry
+    {
+      ScenarioConfig cfg;
+      std::vector<uint64_t> runs;
+      std::vector<PointSettings> points;
+      bool warmStartFork;
+      bool profile;
+    };
+    std::vector<Entry> planned;
+    const uint32_t mpiRank = cfg.mpiRank;
+    const uint32_t mpiSize = cfg.mpiSize;
+    for (const fairness::ScenarioRun& entry : entries)
+    {
+      std::vector<std::string> args{argv[0]};
+      for (const auto& [key, value] : entry.options)
+      {
+        NS_ABORT_MSG_IF(IsProcessOption(key), "--scenarioFile entry '" << entry.name << "': " << key
+                                                                       << " can only be set on the command line");
+        args.push_back("--" + key + "=" + value);
+      }
+      cfg = baseCfg;
+      cfg.mpiRank = mpiRank;
+      cfg.mpiSize = mpiSize;
+      runFirst = baseRunFirst;
+      runLast = baseRunLast;
+      warmStartPoints = baseWarmStartPoints;
+      warmStartFork = baseWarmStartFork;
+      g_callbackProfile.enabled = baseProfile;
+      cmd.Parse(args);
+      ValidateConfig(cfg);
+
+      Entry e{cfg, entry.seeds.empty() ? RunRange(runFirst, runLast) : entry.seeds, ParsePoints(warmStartPoints),
+              warmStartFork, g_callbackProfile.enabled};
+      NS_ABORT_MSG_IF(!e.points.empty() && e.cfg.nBss > 1,
+                      "--scenarioFile entry '" << entry.name << "': --warmStartPoints supports a single BSS only");
+      planned.push_back(std::move(e));
+    }
+
+    for (size_t i = 0; i < planned.size(); ++i)
+    {
+      const Entry& e = planned[i];
+      std::cout << "Scenario: " << (i + 1) << "/" << planned.size() << " name=" << entries[i].name << "\n";
+      g_callbackProfile.enabled = e.profile;
+      // Entries follow each other in one process: always reset
+      RunReplications(e.cfg, e.runs, true, e.points, e.warmStartFork, records, histFile, intervals, ulTrace);
+    }
+  }
+
+  if (histFile)
+    std::fclose(histFile);
+  if (intervals && intervals->GetDropped() > 0)
+  {
+    std::cerr << "Warning: " << intervals->GetDropped() << " interval records dropped (slow or absent reader)\n";
+  }
+  intervalStream.Close();
+  if (ulTrace && ulTrace->GetOverwritten() > 0)
+  {
+    std::cout << "UL trace: " << ulTrace->GetOverwritten() << " older events overwritten (--ulTraceLast="
+              << ulTraceLast << ")\n";
+  }
+  ulTraceWriter.Close();
+#ifdef NS3_MPI
+  if (cfg.mpi)
+  {
+    MpiInterface::Disable();
+  }
+#endif
   return 0;
 }
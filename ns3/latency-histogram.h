@@ -0,0 +1,185 @@
+/**
+ * Fixed-bucket log-linear histogram for uplink one-way delay and jitter.
+ *
+ * Values (microseconds) below 2^kSubBits are counted exactly; above that,
+ * every power-of-two range is split into 2^kSubBits equal sub-buckets, so any
+ * value is reported with a relative error below 2^-kSubBits (6.25%). Memory is
+ * a fixed array of counters: recording never allocates, regardless of how many
+ * packets arrive, and two histograms are merged by adding their counters
+ * (e.g. across RngRuns in fairness-aggregate).
+ *
+ * Text serialization (one line, sparse):
+ *   <count> <sum> <max> <bucket>:<count> <bucket>:<count> ...
+ *
+ * This header has no ns-3 dependency.
+ */
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace fairness
+{
+
+class LatencyHistogram
+{
+public:
+  static constexpr uint32_t kSubBits = 4;
+  static constexpr uint32_t kSub = 1u << kSubBits;
+  // Largest power of two tracked: 2^kMaxExp us (~12.7 days); larger values saturate.
+  static constexpr uint32_t kMaxExp = 39;
+  static constexpr uint32_t kBuckets = (kMaxExp - kSubBits + 2) * kSub;
+
+  void Add(uint64_t us)
+  {
+    const uint64_t clamped = us < (1ULL << (kMaxExp + 1)) ? us : (1ULL << (kMaxExp + 1)) - 1;
+    m_buckets[Index(clamped)]++;
+    m_count++;
+    m_sum += us;
+    if (us > m_max)
+      m_max = us;
+  }
+
+  void Merge(const LatencyHistogram& o)
+  {
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      m_buckets[i] += o.m_buckets[i];
+    }
+    m_count += o.m_count;
+    m_sum += o.m_sum;
+    if (o.m_max > m_max)
+      m_max = o.m_max;
+  }
+
+  void Reset()
+  {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+  }
+
+  uint64_t Count() const
+  {
+    return m_count;
+  }
+
+  uint64_t Max() const
+  {
+    return m_max;
+  }
+
+  double Mean() const
+  {
+    return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0;
+  }
+
+  // Upper edge of the bucket holding the q-quantile (0 < q <= 1), capped at Max().
+  double Percentile(double q) const
+  {
+    if (m_count == 0)
+      return 0.0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(m_count) + 0.999999999);
+    if (rank < 1)
+      rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      seen += m_buckets[i];
+      if (seen >= rank)
+      {
+        const uint64_t upper = LowerBound(i) + Width(i) - 1;
+        return static_cast<double>(upper < m_max ? upper : m_max);
+      }
+    }
+    return static_cast<double>(m_max);
+  }
+
+  std::string Serialize() const
+  {
+    std::string out = std::to_string(m_count) + " " + std::to_string(m_sum) + " " + std::to_string(m_max);
+    char item[48];
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      if (m_buckets[i] == 0)
+        continue;
+      std::snprintf(item, sizeof(item), " %u:%llu", i, (unsigned long long)m_buckets[i]);
+      out += item;
+    }
+    return out;
+  }
+
+  // Parses (and merges into *this) the output of Serialize(); returns false on malformed input.
+  bool MergeSerialized(const char* s)
+  {
+    char* end = nullptr;
+    const uint64_t count = std::strtoull(s, &end, 10);
+    if (end == s)
+      return false;
+    s = end;
+    const uint64_t sum = std::strtoull(s, &end, 10);
+    s = end;
+    const uint64_t max = std::strtoull(s, &end, 10);
+    s = end;
+
+    LatencyHistogram h;
+    h.m_count = count;
+    h.m_sum = sum;
+    h.m_max = max;
+    while (*s)
+    {
+      const unsigned long idx = std::strtoul(s, &end, 10);
+      if (end == s || *end != ':')
+        break;
+      s = end + 1;
+      const uint64_t c = std::strtoull(s, &end, 10);
+      s = end;
+      if (idx >= kBuckets)
+        return false;
+      h.m_buckets[idx] += c;
+    }
+    Merge(h);
+    return true;
+  }
+
+private:
+  static uint32_t Index(uint64_t v)
+  {
+    if (v < kSub)
+      return static_cast<uint32_t>(v);
+    const uint32_t e = 63 - static_cast<uint32_t>(__builtin_clzll(v)); // floor(log2 v) >= kSubBits
+    const uint32_t sub = static_cast<uint32_t>(v >> (e - kSubBits)) - kSub;
+    return ((e - kSubBits + 1) << kSubBits) + sub;
+  }
+
+  static uint64_t LowerBound(uint32_t idx)
+  {
+    if (idx < kSub)
+      return idx;
+    const uint32_t e = (idx >> kSubBits) + kSubBits - 1;
+    const uint64_t sub = idx & (kSub - 1);
+    return (kSub + sub) << (e - kSubBits);
+  }
+
+  static uint64_t Width(uint32_t idx)
+  {
+    if (idx < kSub)
+      return 1;
+    const uint32_t e = (idx >> kSubBits) + kSubBits - 1;
+    return 1ULL << (e - kSubBits);
+  }
+
+  std::array<uint64_t, kBuckets> m_buckets{};
+  uint64_t m_count{0};
+  uint64_t m_sum{0};
+  uint64_t m_max{0};
+};
+
+} // namespace fairness
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,436 @@
+/**
+ * Scenario files for fairness11ax --scenarioFile=<path>: a list of runs
+ * executed back to back in one process.
+ *
+ * JSON, either an array of run objects or an object
+ *
+ *   {
+ *     "defaults": { "simTime": 10, "metrics": "throughput,latency" },
+ *     "runs": [
+ *       { "name": "2/8 rr", "nLegacy": 2, "mHe": 8, "lambdas": [500, 500, 900, ...],
+ *         "apCwMin": 7, "apCwMax": 63, "mu": 0.01, "seeds": [0, 1, 2] },
+ *       { "name": "2/8 fair", "nLegacy": 2, "mHe": 8, "muScheduler": "fair", "seeds": [0, 1, 2] }
+ *     ]
+ *   }
+ *
+ * Keys are fairness11ax command-line option names; the value of "defaults"
+ * applies to every run and a run's own keys override it. Numbers are passed
+ * as written, booleans as true/false and arrays of scalars as comma-separated
+ * lists. Besides the options:
+ *   name    label printed before the run's result blocks
+ *   seeds   RngRuns of the entry (array), instead of --runFirst/--runLast
+ *   lambdas alias of lambdaList
+ *   mu      alias of muAccessReqInterval (a bare number is in seconds)
+ *
+ * This header has no ns-3 dependency.
+ */
+#ifndef SCENARIO_FILE_H
+#define SCENARIO_FILE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fairness
+{
+
+struct ScenarioRun
+{
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> options; // (option name, value), in file order
+  std::vector<uint64_t> seeds;                              // empty: runFirst/runLast or --RngRun
+};
+
+namespace detail
+{
+
+struct JsonValue
+{
+  enum Type
+  {
+    NUL,
+    BOOL,
+    NUMBER,
+    STRING,
+    ARRAY,
+    OBJECT
+  };
+
+  Type type{NUL};
+  std::string text; // BOOL: true/false, NUMBER: token as written, STRING: decoded
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+// Recursive descent over the whole document; the first error wins.
+class JsonParser
+{
+public:
+  explicit JsonParser(const std::string& s)
+    : m_s(s)
+  {
+  }
+
+  bool Parse(JsonValue* out, std::string* error)
+  {
+    bool ok = Value(out, 0);
+    Skip();
+    ok = ok && (m_pos == m_s.size() || Fail("trailing characters"));
+    if (!ok && error)
+      *error = m_error + " at line " + std::to_string(Line());
+    return ok;
+  }
+
+private:
+  static constexpr int kMaxDepth = 32;
+
+  bool Fail(const char* what)
+  {
+    if (m_error.empty())
+      m_error = what;
+    return false;
+  }
+
+  size_t Line() const
+  {
+    size_t line = 1;
+    for (size_t i = 0; i < m_pos && i < m_s.size(); ++i)
+      line += m_s[i] == '\n';
+    return line;
+  }
+
+  void Skip()
+  {
+    while (m_pos < m_s.size() && (m_s[m_pos] == ' ' || m_s[m_pos] == '\t' || m_s[m_pos] == '\n' || m_s[m_pos] == '\r'))
+      m_pos++;
+  }
+
+  bool Literal(const char* word)
+  {
+    const std::string w(word);
+    if (m_s.compare(m_pos, w.size(), w) != 0)
+      return Fail("invalid literal");
+    m_pos += w.size();
+    return true;
+  }
+
+  bool Value(JsonValue* v, int depth)
+  {
+    if (depth > kMaxDepth)
+      return Fail("nesting too deep");
+    Skip();
+    if (m_pos >= m_s.size())
+      return Fail("unexpected end of input");
+    const char c = m_s[m_pos];
+    if (c == '{')
+      return Object(v, depth);
+    if (c == '[')
+      return Array(v, depth);
+    if (c == '"')
+    {
+      v->type = JsonValue::STRING;
+      return String(&v->text);
+    }
+    if (c == 't' || c == 'f')
+    {
+      v->type = JsonValue::BOOL;
+      v->text = (c == 't') ? "true" : "false";
+      return Literal(v->text.c_str());
+    }
+    if (c == 'n')
+    {
+      v->type = JsonValue::NUL;
+      return Literal("null");
+    }
+    return Number(v);
+  }
+
+  bool Number(JsonValue* v)
+  {
+    const size_t start = m_pos;
+    while (m_pos < m_s.size() && std::string("+-0123456789.eE").find(m_s[m_pos]) != std::string::npos)
+      m_pos++;
+    v->type = JsonValue::NUMBER;
+    v->text = m_s.substr(start, m_pos - start);
+    char* end = nullptr;
+    std::strtod(v->text.c_str(), &end);
+    if (v->text.empty() || *end != '\0')
+      return Fail("invalid value");
+    return true;
+  }
+
+  bool String(std::string* out)
+  {
+    m_pos++; // opening quote
+    out->clear();
+    while (m_pos < m_s.size() && m_s[m_pos] != '"')
+    {
+      char c = m_s[m_pos++];
+      if (c != '\\')
+      {
+        out->push_back(c);
+        continue;
+      }
+      if (m_pos >= m_s.size())
+        break;
+      c = m_s[m_pos++];
+      switch (c)
+      {
+      case '"':
+      case '\\':
+      case '/':
+        out->push_back(c);
+        break;
+      case 'n':
+        out->push_back('\n');
+        break;
+      case 't':
+        out->push_back('\t');
+        break;
+      case 'r':
+        out->push_back('\r');
+        break;
+      case 'b':
+        out->push_back('\b');
+        break;
+      case 'f':
+        out->push_back('\f');
+        break;
+      case 'u': {
+        if (m_pos + 4 > m_s.size())
+          return Fail("bad \\u escape");
+        const unsigned long cp = std::strtoul(m_s.substr(m_pos, 4).c_str(), nullptr, 16);
+        m_pos += 4;
+        // Basic multilingual plane only (option values are ASCII anyway)
+        if (cp < 0x80)
+        {
+          out->push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800)
+        {
+          out->push_back(static_cast<char>(0xc0 | (cp >> 6)));
+          out->push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else
+        {
+          out->push_back(static_cast<char>(0xe0 | (cp >> 12)));
+          out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+          out->push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        break;
+      }
+      default:
+        return Fail("bad escape");
+      }
+    }
+    if (m_pos >= m_s.size())
+      return Fail("unterminated string");
+    m_pos++; // closing quote
+    return true;
+  }
+
+  bool Array(JsonValue* v, int depth)
+  {
+    v->type = JsonValue::ARRAY;
+    m_pos++;
+    Skip();
+    if (m_pos < m_s.size() && m_s[m_pos] == ']')
+    {
+      m_pos++;
+      return true;
+    }
+    while (true)
+    {
+      v->items.emplace_back();
+      if (!Value(&v->items.back(), depth + 1))
+        return false;
+      Skip();
+      if (m_pos < m_s.size() && m_s[m_pos] == ',')
+      {
+        m_pos++;
+        continue;
+      }
+      if (m_pos < m_s.size() && m_s[m_pos] == ']')
+      {
+        m_pos++;
+        return true;
+      }
+      return Fail("expected ',' or ']'");
+    }
+  }
+
+  bool Object(JsonValue* v, int depth)
+  {
+    v->type = JsonValue::OBJECT;
+    m_pos++;
+    Skip();
+    if (m_pos < m_s.size() && m_s[m_pos] == '}')
+    {
+      m_pos++;
+      return true;
+    }
+    while (true)
+    {
+      Skip();
+      if (m_pos >= m_s.size() || m_s[m_pos] != '"')
+        return Fail("expected a string key");
+      std::string key;
+      if (!String(&key))
+        return false;
+      Skip();
+      if (m_pos >= m_s.size() || m_s[m_pos] != ':')
+        return Fail("expected ':'");
+      m_pos++;
+      v->members.emplace_back(key, JsonValue());
+      if (!Value(&v->members.back().second, depth + 1))
+        return false;
+      Skip();
+      if (m_pos < m_s.size() && m_s[m_pos] == ',')
+      {
+        m_pos++;
+        continue;
+      }
+      if (m_pos < m_s.size() && m_s[m_pos] == '}')
+      {
+        m_pos++;
+        return true;
+      }
+      return Fail("expected ',' or '}'");
+    }
+  }
+
+  const std::string& m_s;
+  size_t m_pos{0};
+  std::string m_error;
+};
+
+// Scalar or array of scalars as a command-line value
+inline bool OptionText(const JsonValue& v, std::string* out)
+{
+  if (v.type == JsonValue::BOOL || v.type == JsonValue::NUMBER || v.type == JsonValue::STRING)
+  {
+    *out = v.text;
+    return true;
+  }
+  if (v.type != JsonValue::ARRAY)
+    return false;
+  out->clear();
+  for (size_t i = 0; i < v.items.size(); ++i)
+  {
+    const JsonValue& item = v.items[i];
+    if (item.type != JsonValue::BOOL && item.type != JsonValue::NUMBER && item.type != JsonValue::STRING)
+      return false;
+    *out += (i ? "," : "") + item.text;
+  }
+  return true;
+}
+
+inline bool AddMembers(const JsonValue& obj, ScenarioRun* run, std::string* error)
+{
+  for (const auto& [key, value] : obj.members)
+  {
+    if (key == "name")
+    {
+      if (value.type != JsonValue::STRING)
+        return (*error = "\"name\" must be a string", false);
+      run->name = value.text;
+      continue;
+    }
+    if (key == "seeds")
+    {
+      if (value.type != JsonValue::ARRAY)
+        return (*error = "\"seeds\" must be an array of RngRuns", false);
+      run->seeds.clear();
+      for (const JsonValue& s : value.items)
+      {
+        char* end = nullptr;
+        const unsigned long long seed = std::strtoull(s.text.c_str(), &end, 10);
+        if (s.type != JsonValue::NUMBER || s.text[0] == '-' || *end != '\0')
+          return (*error = "bad seed '" + s.text + "' (expected a non-negative integer)", false);
+        run->seeds.push_back(seed);
+      }
+      continue;
+    }
+    std::string text;
+    if (!OptionText(value, &text))
+      return (*error = "\"" + key + "\": expected a scalar or an array of scalars", false);
+    const std::string option = (key == "lambdas") ? "lambdaList" : (key == "mu") ? "muAccessReqInterval" : key;
+    run->options.emplace_back(option, text);
+  }
+  return true;
+}
+
+} // namespace detail
+
+/**
+ * Read a scenario file into one ScenarioRun per entry (defaults merged in).
+ * Returns false with a message in *error on I/O or syntax errors.
+ */
+inline bool LoadScenarioFile(const std::string& path, std::vector<ScenarioRun>* runs, std::string* error)
+{
+  using detail::JsonValue;
+  std::ifstream in(path);
+  if (!in)
+  {
+    *error = "cannot open " + path;
+    return false;
+  }
+  std::stringstream buf;
+  buf << in.rdbuf();
+  const std::string text = buf.str();
+
+  JsonValue doc;
+  if (!detail::JsonParser(text).Parse(&doc, error))
+    return false;
+
+  const JsonValue* defaults = nullptr;
+  const JsonValue* list = &doc;
+  if (doc.type == JsonValue::OBJECT)
+  {
+    list = nullptr;
+    for (const auto& [key, value] : doc.members)
+    {
+      if (key == "defaults" && value.type == JsonValue::OBJECT)
+        defaults = &value;
+      else if (key == "runs")
+        list = &value;
+      else
+        return (*error = "unexpected top-level key \"" + key + "\" (expected defaults, runs)", false);
+    }
+  }
+  if (!list || list->type != JsonValue::ARRAY)
+  {
+    *error = "expected an array of runs (or an object with \"runs\")";
+    return false;
+  }
+
+  runs->clear();
+  for (size_t i = 0; i < list->items.size(); ++i)
+  {
+    const JsonValue& entry = list->items[i];
+    ScenarioRun run;
+    run.name = "run" + std::to_string(i);
+    std::string what;
+    if (entry.type != JsonValue::OBJECT)
+      what = "expected an object";
+    else if (defaults && !detail::AddMembers(*defaults, &run, &what))
+      what = "defaults: " + what;
+    else
+      detail::AddMembers(entry, &run, &what);
+    if (!what.empty())
+    {
+      *error = "runs[" + std::to_string(i) + "]: " + what;
+      return false;
+    }
+    runs->push_back(std::move(run));
+  }
+  return true;
+}
+
+} // namespace fairness
+
+#endif /* SCENARIO_FILE_H */
@@ -0,0 +1,225 @@
+/**
+ * ul-ofdma-model: command-line front end of the analytical model in
+ * ul-ofdma-model.h.
+ *
+ * Usage:
+ *   ul-ofdma-model --nL=2 --nH=8 --mu=0.01 --cwmin=15 --cwmax=1023
+ *       one point
+ *   ul-ofdma-model --screen --nL=2 --nH=8 --mu=0,0.001,0.01 [--cw=1,3,...,1023]
+ *       CSV of every (mu, cwmin <= cwmax) pair
+ *   ul-ofdma-model --best --eta=0.95 --nL=2 --nH=8 --mu=0,0.001,0.01
+ *       best pair with Jain_group >= eta per mu, in the columns of
+ *       best_cw_fairness_eta0p95_obs_vs_model.csv
+ *   ul-ofdma-model --bench=1000000
+ *       evaluates random points and prints points/s
+ *
+ * Model constants can be overridden with --payloadSize, --ampduLegacy,
+ * --ampduHe, --maxTbStations, --tbPpduUs.
+ *
+ * This tool has no ns-3 dependency: it builds as an ns-3 scratch program next
+ * to fairness11ax, or standalone with
+ *   g++ -O3 -ffast-math -std=c++17 -o ul-ofdma-model ul-ofdma-model.cc
+ */
+
+#include "ul-ofdma-model.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<double> ParseList(const std::string& s)
+{
+  std::vector<double> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    if (!item.empty())
+      out.push_back(std::strtod(item.c_str(), nullptr));
+  }
+  return out;
+}
+
+void Usage()
+{
+  std::fprintf(stderr,
+               "usage: ul-ofdma-model [--nL=N] [--nH=N] [--mu=S[,S...]] [--cwmin=N] [--cwmax=N]\n"
+               "                      [--screen | --best [--eta=0.95] | --bench=N] [--cw=N,N,...]\n"
+               "                      [--payloadSize=B] [--ampduLegacy=N] [--ampduHe=N]\n"
+               "                      [--maxTbStations=N] [--tbPpduUs=US]\n");
+}
+
+// All (mu, cwmin <= cwmax) points of one population
+void FillGrid(fairness::ModelBatch& b, double nL, double nH, const std::vector<double>& mus,
+              const std::vector<double>& cws)
+{
+  size_t n = 0;
+  for (size_t i = 0; i < cws.size(); ++i)
+    for (size_t j = i; j < cws.size(); ++j)
+      ++n;
+  b.Resize(n * mus.size());
+  size_t k = 0;
+  for (double mu : mus)
+    for (size_t i = 0; i < cws.size(); ++i)
+      for (size_t j = i; j < cws.size(); ++j)
+        b.Set(k++, nL, nH, mu, cws[i], cws[j]);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  fairness::ModelParams mp;
+  double nL = 2;
+  double nH = 8;
+  std::vector<double> mus{0.01};
+  double cwMin = 15;
+  double cwMax = 1023;
+  std::vector<double> cws{1, 3, 7, 15, 31, 63, 127, 255, 511, 1023};
+  double eta = 0.95;
+  std::string mode = "point";
+  long benchN = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const size_t eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string val = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+    const double num = std::strtod(val.c_str(), nullptr);
+    if (key == "--nL")
+      nL = num;
+    else if (key == "--nH")
+      nH = num;
+    else if (key == "--mu")
+      mus = ParseList(val);
+    else if (key == "--cwmin")
+      cwMin = num;
+    else if (key == "--cwmax")
+      cwMax = num;
+    else if (key == "--cw")
+      cws = ParseList(val);
+    else if (key == "--eta")
+      eta = num;
+    else if (key == "--screen")
+      mode = "screen";
+    else if (key == "--best")
+      mode = "best";
+    else if (key == "--bench")
+    {
+      mode = "bench";
+      benchN = std::strtol(val.c_str(), nullptr, 10);
+    }
+    else if (key == "--payloadSize")
+      mp.payloadBytes = num;
+    else if (key == "--ampduLegacy")
+      mp.ampduLegacy = num;
+    else if (key == "--ampduHe")
+      mp.ampduHe = num;
+    else if (key == "--maxTbStations")
+      mp.maxTbStations = num;
+    else if (key == "--tbPpduUs")
+      mp.tbPpduUs = num;
+    else if (key == "--help" || key == "-h")
+    {
+      Usage();
+      return 0;
+    }
+    else
+    {
+      Usage();
+      return 2;
+    }
+  }
+  if (mus.empty() || cws.empty() || (mode == "bench" && benchN <= 0))
+  {
+    Usage();
+    return 2;
+  }
+
+  fairness::ModelBatch b;
+
+  if (mode == "point")
+  {
+    for (double mu : mus)
+    {
+      const fairness::ModelResult r = fairness::EvaluatePoint(mp, nL, nH, mu, cwMin, cwMax);
+      std::printf("nL=%g nH=%g mu=%g apCwMin=%g apCwMax=%g  thr_total=%.6f Mbps  HE(11ax)=%.6f Mbps  "
+                  "Legacy(11ac)=%.6f Mbps  Jain_group=%.6f  q=%.6f  iterations=%d\n",
+                  nL, nH, mu, cwMin, cwMax, r.thrTotal, r.thrHeAvg, r.thrLegacyAvg, r.jainGroup, r.q,
+                  r.iterations);
+    }
+    return 0;
+  }
+
+  if (mode == "bench")
+  {
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<int> pop(0, 20);
+    std::uniform_int_distribution<int> exp(1, 10);
+    std::uniform_real_distribution<double> mu(0.0, 0.1);
+    b.Resize(static_cast<size_t>(benchN));
+    for (long i = 0; i < benchN; ++i)
+    {
+      const int e0 = exp(gen);
+      const int e1 = std::max(e0, exp(gen));
+      b.Set(i, pop(gen), pop(gen) + 1, mu(gen), (1 << e0) - 1, (1 << e1) - 1);
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    fairness::EvaluateBatch(mp, b);
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    long unconverged = 0;
+    double checksum = 0.0;
+    for (long i = 0; i < benchN; ++i)
+    {
+      unconverged += (b.iterations[i] >= mp.maxIter);
+      checksum += b.thrTotal[i];
+    }
+    std::printf("bench points=%ld wall=%.3fs points/s=%.0f unconverged=%ld checksum=%.6g\n", benchN, wall,
+                wall > 0 ? benchN / wall : 0.0, unconverged, checksum);
+    return 0;
+  }
+
+  FillGrid(b, nL, nH, mus, cws);
+  fairness::EvaluateBatch(mp, b);
+
+  if (mode == "screen")
+  {
+    std::printf("nLegacy,nHe,mu,apCwMin,apCwMax,thr_total_mbps,thr_he_avg_mbps,thr_legacy_avg_mbps,jain_group,q\n");
+    for (size_t i = 0; i < b.Size(); ++i)
+    {
+      std::printf("%g,%g,%g,%g,%g,%.6f,%.6f,%.6f,%.6f,%.6f\n", b.nLegacy[i], b.nHe[i], b.muSec[i], b.apCwMin[i],
+                  b.apCwMax[i], b.thrTotal[i], b.thrHeAvg[i], b.thrLegacyAvg[i], b.jainGroup[i], b.q[i]);
+    }
+    return 0;
+  }
+
+  // --best: grid is laid out mu-major
+  std::printf("nL,nH,mu,model_best_thr,model_best_cwmin,model_best_cwmax,model_best_jain\n");
+  const size_t perMu = b.Size() / mus.size();
+  for (size_t m = 0; m < mus.size(); ++m)
+  {
+    long best = -1;
+    for (size_t i = m * perMu; i < (m + 1) * perMu; ++i)
+    {
+      if (b.jainGroup[i] >= eta && (best < 0 || b.thrTotal[i] > b.thrTotal[best]))
+        best = static_cast<long>(i);
+    }
+    if (best < 0)
+    {
+      std::printf("%g,%g,%g,,,,\n", nL, nH, mus[m]);
+      continue;
+    }
+    std::printf("%g,%g,%g,%.6f,%g,%g,%.6f\n", nL, nH, mus[m], b.thrTotal[best], b.apCwMin[best],
+                b.apCwMax[best], b.jainGroup[best]);
+  }
+  return 0;
+}
@@ -0,0 +1,326 @@
+/**
+ * Saturated-uplink throughput/fairness model of the mixed 802.11ac/ax BSS.
+ *
+ * One point is (nL legacy STAs, nH HE STAs, mu = MU scheduler
+ * AccessReqInterval, AP BE CWmin/CWmax). The model is a Bianchi-style
+ * fixed point over three contender classes sharing one EDCA BE channel:
+ *
+ *   - legacy and HE STAs: saturated, STA CWmin/CWmax, SU A-MPDU per success;
+ *   - the AP: contends with the swept CW only while a trigger is pending,
+ *     which happens with probability rho. Triggers are requested every mu
+ *     (AccessReqInterval) and, with mu = 0, only when the AP gains access for
+ *     its beacons, so rho = min(1, (1/mu + 1/beacon) * D_AP) with D_AP the
+ *     AP's mean access delay. An AP success is a trigger-based exchange in
+ *     which up to maxTbStations HE STAs send in parallel on their RUs.
+ *
+ * Per class, tau(p) = sum_k p^k / sum_k p^k (W_k + 1) / 2 over the
+ * retryLimit + 1 attempts (W_k = min(2^k (CWmin + 1), CWmax + 1)), and
+ * p = 1 - prod(other contenders idle). The fixed point in
+ * (tau_L, tau_H, tau_AP, rho) is solved by damped iteration. Outputs are the
+ * per-station mean throughput of each group, their sum over all stations,
+ * Jain_group (the HE-vs-legacy Jain index of process.awk) and q, the
+ * fraction of HE MPDUs sent in HE TB PPDUs (the quantity of
+ * figures/model_validation/q_mu.png).
+ *
+ * The PHY/MAC constants in ModelParams are nominal ns-3.46 values for the
+ * 20 MHz scenario, not a fit: calibrate them against fairness11ax output
+ * before trusting absolute numbers.
+ *
+ * EvaluateBatch() works on structure-of-arrays inputs and iterates lanes of
+ * kModelLanes points in lockstep with straight-line, branch-free arithmetic,
+ * so the compiler can vectorize the inner loops (e.g. -O3 -ffast-math, which
+ * lets glibc's vector exp/log be used).
+ *
+ * This header has no ns-3 dependency.
+ */
+#ifndef UL_OFDMA_MODEL_H
+#define UL_OFDMA_MODEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fairness
+{
+
+struct ModelParams
+{
+  // MAC timing (us)
+  double slotUs{9.0};
+  double sifsUs{16.0};
+  double aifsn{3.0}; // BE
+  // Frame sizes (bytes): UDP payload plus UDP/IP/LLC/MAC/FCS/A-MPDU delimiter
+  double payloadBytes{1000.0};
+  double mpduOverheadBytes{70.0};
+  // SU PPDUs
+  double legacyRateMbps{78.0}; // VHT MCS 8, 20 MHz, 1 SS, 800 ns GI
+  double legacyPreambleUs{40.0};
+  double heRateMbps{143.4};    // HE MCS 11, 20 MHz, 1 SS, 800 ns GI
+  double hePreambleUs{48.0};
+  double ampduLegacy{16.0};    // MPDUs per SU success
+  double ampduHe{16.0};
+  double blockAckUs{32.0};
+  // Trigger-based exchange: Trigger, SIFS, HE TB PPDU, SIFS, multi-STA BlockAck
+  double maxTbStations{4.0};   // RrMultiUserScheduler NStations
+  double tbRuRateMbps{25.0};   // per-STA rate on its RU
+  double tbPpduUs{2000.0};
+  double hetbPreambleUs{48.0};
+  double triggerUs{68.0};
+  double multiStaBaUs{68.0};
+  double beaconIntervalUs{102400.0};
+  // Backoff
+  double staCwMin{15.0};
+  double staCwMax{1023.0};
+  int retryLimit{6}; // retransmissions after the first attempt
+  // Solver
+  int maxIter{500};
+  double tol{1e-10};
+  double damping{0.5};
+};
+
+constexpr size_t kModelLanes = 8;
+constexpr int kMaxRetryLimit = 15;
+
+/**
+ * Structure-of-arrays batch: fill the inputs (Resize(n) first), call
+ * EvaluateBatch(), read the outputs. Throughputs are Mbps.
+ */
+struct ModelBatch
+{
+  // inputs
+  std::vector<double> nLegacy;
+  std::vector<double> nHe;
+  std::vector<double> muSec;
+  std::vector<double> apCwMin;
+  std::vector<double> apCwMax;
+  // outputs
+  std::vector<double> thrTotal;  // sum over all stations
+  std::vector<double> thrHeAvg;  // per HE station
+  std::vector<double> thrLegacyAvg;
+  std::vector<double> jainGroup;
+  std::vector<double> q;         // HE MPDUs in TB PPDUs / all HE MPDUs
+  std::vector<int> iterations;   // maxIter if not converged
+
+  size_t Size() const
+  {
+    return nLegacy.size();
+  }
+
+  void Resize(size_t n)
+  {
+    for (std::vector<double>* v : {&nLegacy, &nHe, &muSec, &apCwMin, &apCwMax, &thrTotal, &thrHeAvg,
+                                   &thrLegacyAvg, &jainGroup, &q})
+    {
+      v->resize(n);
+    }
+    iterations.resize(n);
+  }
+
+  void Set(size_t i, double nL, double nH, double mu, double cwMin, double cwMax)
+  {
+    nLegacy[i] = nL;
+    nHe[i] = nH;
+    muSec[i] = mu;
+    apCwMin[i] = cwMin;
+    apCwMax[i] = cwMax;
+  }
+};
+
+namespace detail
+{
+
+// (1 - x)^n for n >= 0 (n may be 0 or fractional), x in [0, 1)
+inline double PowIdle(double x, double n)
+{
+  return std::exp(n * std::log1p(-x));
+}
+
+} // namespace detail
+
+inline void EvaluateBatch(const ModelParams& mp, ModelBatch& b)
+{
+  const size_t n = b.Size();
+  const int nStages = std::min(mp.retryLimit, kMaxRetryLimit) + 1;
+  const double bitsPerMpdu = (mp.payloadBytes + mp.mpduOverheadBytes) * 8.0;
+  const double payloadBits = mp.payloadBytes * 8.0;
+  const double aifsUs = mp.sifsUs + mp.aifsn * mp.slotUs;
+
+  // Durations that do not depend on the point
+  const double ppduL = mp.legacyPreambleUs + mp.ampduLegacy * bitsPerMpdu / mp.legacyRateMbps;
+  const double ppduH = mp.hePreambleUs + mp.ampduHe * bitsPerMpdu / mp.heRateMbps;
+  const double tL = aifsUs + ppduL + mp.sifsUs + mp.blockAckUs;
+  const double tH = aifsUs + ppduH + mp.sifsUs + mp.blockAckUs;
+  const double tTb = aifsUs + mp.triggerUs + mp.sifsUs + mp.tbPpduUs + mp.sifsUs + mp.multiStaBaUs;
+  const double tC = aifsUs + std::max(ppduL, ppduH) + mp.sifsUs + mp.blockAckUs;
+  const double mpdusPerRu =
+    std::min(mp.ampduHe, std::floor((mp.tbPpduUs - mp.hetbPreambleUs) * mp.tbRuRateMbps / bitsPerMpdu));
+
+  double staW[kMaxRetryLimit + 1];
+  for (int k = 0; k < nStages; ++k)
+  {
+    staW[k] = std::min(std::ldexp(mp.staCwMin + 1.0, k), mp.staCwMax + 1.0);
+  }
+
+  for (size_t base = 0; base < n; base += kModelLanes)
+  {
+    const size_t lanes = std::min(kModelLanes, n - base);
+
+    // Lane state (unused lanes duplicate the last point)
+    double nL[kModelLanes], nH[kModelLanes], lambdaA[kModelLanes];
+    double apW[kMaxRetryLimit + 1][kModelLanes];
+    double tauL[kModelLanes], tauH[kModelLanes], tauA[kModelLanes], rho[kModelLanes];
+    double pL[kModelLanes], pH[kModelLanes], pA[kModelLanes], eSlot[kModelLanes];
+    for (size_t l = 0; l < kModelLanes; ++l)
+    {
+      const size_t i = base + std::min(l, lanes - 1);
+      nL[l] = b.nLegacy[i];
+      nH[l] = b.nHe[i];
+      // Trigger requests per us: every mu, plus the access the AP gets for beacons
+      lambdaA[l] = (b.muSec[i] > 0.0 ? 1.0 / (b.muSec[i] * 1e6) : 0.0) + 1.0 / mp.beaconIntervalUs;
+      for (int k = 0; k < nStages; ++k)
+      {
+        apW[k][l] = std::min(std::ldexp(b.apCwMin[i] + 1.0, k), b.apCwMax[i] + 1.0);
+      }
+      tauL[l] = tauH[l] = tauA[l] = 2.0 / (mp.staCwMin + 2.0);
+      rho[l] = 0.5;
+      pL[l] = pH[l] = pA[l] = 0.0;
+      eSlot[l] = mp.slotUs;
+    }
+
+    int iter = 0;
+    for (; iter < mp.maxIter; ++iter)
+    {
+      // Each step is a separate loop over the lanes so that it vectorizes.
+      double othersA[kModelLanes], tauAe[kModelLanes];
+      for (size_t l = 0; l < kModelLanes; ++l)
+      {
+        const double idleL = detail::PowIdle(tauL[l], nL[l]);
+        const double idleH = detail::PowIdle(tauH[l], nH[l]);
+        tauAe[l] = rho[l] * tauA[l];
+        // Probability that every *other* contender stays idle
+        const double othersL = idleL / (1.0 - tauL[l]) * idleH * (1.0 - tauAe[l]);
+        const double othersH = idleL * idleH / (1.0 - tauH[l]) * (1.0 - tauAe[l]);
+        othersA[l] = idleL * idleH;
+        // An empty class gets p < 0 here; the clamp keeps Tau well defined.
+        pL[l] = std::min(std::max(1.0 - othersL, 0.0), 1.0);
+        pH[l] = std::min(std::max(1.0 - othersH, 0.0), 1.0);
+        pA[l] = 1.0 - othersA[l];
+
+        const double pIdle = othersA[l] * (1.0 - tauAe[l]);
+        const double psL = nL[l] * tauL[l] * othersL;
+        const double psH = nH[l] * tauH[l] * othersH;
+        const double psA = tauAe[l] * othersA[l];
+        const double pc = std::max(0.0, 1.0 - pIdle - psL - psH - psA);
+        eSlot[l] = pIdle * mp.slotUs + psL * tL + psH * tH + psA * tTb + pc * tC;
+      }
+
+      // tau(p) = sum_k p^k / sum_k p^k (W_k + 1) / 2, stage by stage
+      double numL[kModelLanes], denL[kModelLanes], pkL[kModelLanes];
+      double numH[kModelLanes], denH[kModelLanes], pkH[kModelLanes];
+      double numA[kModelLanes], denA[kModelLanes], pkA[kModelLanes];
+      for (size_t l = 0; l < kModelLanes; ++l)
+      {
+        numL[l] = denL[l] = numH[l] = denH[l] = numA[l] = denA[l] = 0.0;
+        pkL[l] = pkH[l] = pkA[l] = 1.0;
+      }
+      for (int k = 0; k < nStages; ++k)
+      {
+        const double halfStaW = (staW[k] + 1.0) * 0.5;
+        for (size_t l = 0; l < kModelLanes; ++l)
+        {
+          numL[l] += pkL[l];
+          denL[l] += pkL[l] * halfStaW;
+          pkL[l] *= pL[l];
+          numH[l] += pkH[l];
+          denH[l] += pkH[l] * halfStaW;
+          pkH[l] *= pH[l];
+          numA[l] += pkA[l];
+          denA[l] += pkA[l] * (apW[k][l] + 1.0) * 0.5;
+          pkA[l] *= pA[l];
+        }
+      }
+
+      double delta = 0.0;
+      const double d = mp.damping;
+      for (size_t l = 0; l < kModelLanes; ++l)
+      {
+        const double newL = numL[l] / denL[l];
+        const double newH = numH[l] / denH[l];
+        const double newA = numA[l] / denA[l];
+        // AP busy fraction: trigger rate x mean access delay (slots to success x slot length)
+        const double accessDelayUs = eSlot[l] / (newA * std::max(1e-12, 1.0 - pA[l]));
+        const double newRho = std::min(1.0, lambdaA[l] * accessDelayUs);
+
+        const double uL = (1.0 - d) * tauL[l] + d * newL;
+        const double uH = (1.0 - d) * tauH[l] + d * newH;
+        const double uA = (1.0 - d) * tauA[l] + d * newA;
+        const double uR = (1.0 - d) * rho[l] + d * newRho;
+        delta = std::max(delta, std::fabs(uL - tauL[l]) + std::fabs(uH - tauH[l]) + std::fabs(uA - tauA[l]) +
+                                  std::fabs(uR - rho[l]));
+        tauL[l] = uL;
+        tauH[l] = uH;
+        tauA[l] = uA;
+        rho[l] = uR;
+      }
+      if (delta < mp.tol)
+        break;
+    }
+
+    for (size_t l = 0; l < lanes; ++l)
+    {
+      const size_t i = base + l;
+      const double tauAe = rho[l] * tauA[l];
+      const double othersA = 1.0 - pA[l];
+      const double psL = nL[l] * tauL[l] * (1.0 - pL[l]);
+      const double psH = nH[l] * tauH[l] * (1.0 - pH[l]);
+      const double psA = tauAe * othersA;
+      const double tbStations = std::min(nH[l], mp.maxTbStations);
+
+      const double mpduL = psL * mp.ampduLegacy;
+      const double mpduSu = psH * mp.ampduHe;
+      const double mpduTb = psA * tbStations * mpdusPerRu;
+      // bits per us == Mbps
+      const double thrL = mpduL * payloadBits / eSlot[l];
+      const double thrH = (mpduSu + mpduTb) * payloadBits / eSlot[l];
+
+      const double xL = nL[l] > 0.0 ? thrL / nL[l] : 0.0;
+      const double xH = nH[l] > 0.0 ? thrH / nH[l] : 0.0;
+      b.thrTotal[i] = thrL + thrH;
+      b.thrLegacyAvg[i] = xL;
+      b.thrHeAvg[i] = xH;
+      // Jain over the two group means; 1 when only one group exists
+      const double den = 2.0 * (xL * xL + xH * xH);
+      b.jainGroup[i] = (nL[l] > 0.0 && nH[l] > 0.0) ? (den > 0.0 ? (xL + xH) * (xL + xH) / den : 0.0) : 1.0;
+      b.q[i] = (mpduSu + mpduTb) > 0.0 ? mpduTb / (mpduSu + mpduTb) : 0.0;
+      b.iterations[i] = iter;
+    }
+  }
+}
+
+// Single point convenience wrapper around EvaluateBatch.
+struct ModelResult
+{
+  double thrTotal;
+  double thrHeAvg;
+  double thrLegacyAvg;
+  double jainGroup;
+  double q;
+  int iterations;
+};
+
+inline ModelResult EvaluatePoint(const ModelParams& mp, double nL, double nH, double mu, double cwMin,
+                                 double cwMax)
+{
+  ModelBatch b;
+  b.Resize(1);
+  b.Set(0, nL, nH, mu, cwMin, cwMax);
+  EvaluateBatch(mp, b);
+  return ModelResult{b.thrTotal[0], b.thrHeAvg[0], b.thrLegacyAvg[0], b.jainGroup[0], b.q[0],
+                     b.iterations[0]};
+}
+
+} // namespace fairness
+
+#endif /* UL_OFDMA_MODEL_H */
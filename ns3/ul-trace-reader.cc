@@ -0,0 +1,408 @@
+/**
+ * ul-trace-reader: per-trigger statistics of fairness11ax --ulTrace files.
+ *
+ * The file is memory-mapped and scanned once. Events are grouped by
+ * (configHash, run, cell), so the warm-start points of one run stay apart
+ * (version 1 files, without configHash, group as configHash 0), and, within
+ * a cell, by basic trigger: the TRIGGER event, its
+ * ALLOC events (one per user info) and the uplink MPDUs the AP received or
+ * dropped until the next basic trigger. For each trigger:
+ *   users      user info fields (RUs handed out)
+ *   responders allocated STAs with at least one HE TB MPDU received
+ *   tbOk/tbDrop HE TB MPDUs received / dropped (drops are attributed to a
+ *              trigger when the sender was in its allocation)
+ *   tbBytes    bytes of the received HE TB MPDUs
+ * The summary reports their means, the response rate (responders / users),
+ * the share of triggers nobody answered, the responder histogram, the RU
+ * sizes handed out and one line per STA. Events before the first trigger of
+ * a cell (or, with --ulTraceLast, before the first one retained) count as
+ * unattributed.
+ *
+ * Usage:
+ *   ul-trace-reader [--per-trigger] [--run=N] [--bss=B] [--config=HASH] file ...
+ * --per-trigger prints one CSV row per trigger instead of the summary;
+ * --config keeps the events of one configHash (hex, as in the Manifest line).
+ *
+ * This tool has no ns-3 dependency: it builds as an ns-3 scratch program next
+ * to fairness11ax, or standalone with
+ *   g++ -O2 -std=c++17 -o ul-trace-reader ul-trace-reader.cc
+ */
+
+#include "ul-trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+using fairness::UlTraceEvent;
+
+// (configHash, run, bss)
+using CellKey = std::tuple<uint64_t, uint32_t, uint16_t>;
+
+constexpr size_t kMaxResponderBins = 17; // last bin: >= 16
+constexpr size_t kRuNames = sizeof(fairness::kUlTraceRuNames) / sizeof(fairness::kUlTraceRuNames[0]);
+
+// Open trigger of one cell
+struct TriggerAcc
+{
+  bool open{false};
+  uint64_t configHash{0};
+  uint32_t run{0};
+  uint16_t bss{0};
+  uint32_t trigger{0};
+  int64_t timeNs{0};
+  uint32_t users{0};
+  uint32_t ulLength{0};
+  std::vector<uint16_t> allocated;
+  std::vector<uint16_t> responders;
+  uint64_t tbOk{0};
+  uint64_t tbDrop{0};
+  uint64_t tbBytes{0};
+  uint64_t mcsSum{0};
+  uint64_t mcsCount{0};
+};
+
+struct StaAcc
+{
+  uint64_t allocated{0};
+  uint64_t answered{0};
+  uint64_t tbOk{0};
+  uint64_t tbDrop{0};
+  uint64_t tbBytes{0};
+  uint64_t suOk{0};
+  uint64_t nonHeOk{0};
+  uint64_t otherDrop{0}; // dropped outside an allocation
+  uint64_t mcsSum{0};
+  uint64_t mcsCount{0};
+};
+
+struct Summary
+{
+  uint64_t events{0};
+  uint64_t triggers{0};
+  uint64_t users{0};
+  uint64_t responders{0};
+  uint64_t emptyTriggers{0};
+  uint64_t tbOk{0};
+  uint64_t tbDrop{0};
+  uint64_t tbBytes{0};
+  uint64_t unattributed{0};
+  std::array<uint64_t, kMaxResponderBins> respondersHist{};
+  std::array<uint64_t, kRuNames + 1> ruSizes{}; // last: unknown
+  std::map<CellKey, bool> cells;
+  std::vector<StaAcc> stas;
+
+  StaAcc& Sta(uint16_t sta)
+  {
+    if (sta >= stas.size())
+      stas.resize(sta + 1);
+    return stas[sta];
+  }
+};
+
+bool Contains(const std::vector<uint16_t>& v, uint16_t x)
+{
+  return std::find(v.begin(), v.end(), x) != v.end();
+}
+
+void CloseTrigger(TriggerAcc& t, Summary& s, bool perTrigger)
+{
+  if (!t.open)
+    return;
+  t.open = false;
+  s.triggers++;
+  s.users += t.users;
+  s.responders += t.responders.size();
+  s.emptyTriggers += t.responders.empty();
+  s.tbOk += t.tbOk;
+  s.tbDrop += t.tbDrop;
+  s.tbBytes += t.tbBytes;
+  s.respondersHist[std::min(t.responders.size(), kMaxResponderBins - 1)]++;
+  for (uint16_t sta : t.allocated)
+  {
+    if (sta == fairness::kUlTraceNoSta)
+      continue;
+    StaAcc& a = s.Sta(sta);
+    a.allocated++;
+    a.answered += Contains(t.responders, sta);
+  }
+  if (perTrigger)
+  {
+    std::printf("%u,%u,%u,%lld,%u,%u,%zu,%llu,%llu,%llu,%.2f,%016llx\n", t.run, t.bss, t.trigger,
+                (long long)t.timeNs, t.users, t.ulLength, t.responders.size(), (unsigned long long)t.tbOk,
+                (unsigned long long)t.tbDrop, (unsigned long long)t.tbBytes,
+                t.mcsCount ? double(t.mcsSum) / double(t.mcsCount) : -1.0, (unsigned long long)t.configHash);
+  }
+}
+
+void AddEvent(const UlTraceEvent& e, std::map<CellKey, TriggerAcc>& open, Summary& s, bool perTrigger)
+{
+  s.events++;
+  const CellKey key{e.configHash, e.run, e.bss};
+  s.cells[key] = true;
+  TriggerAcc& t = open[key];
+
+  if (e.kind == fairness::UL_TRACE_TRIGGER)
+  {
+    CloseTrigger(t, s, perTrigger);
+    t = TriggerAcc{};
+    t.open = true;
+    t.configHash = e.configHash;
+    t.run = e.run;
+    t.bss = e.bss;
+    t.trigger = e.trigger;
+    t.timeNs = e.timeNs;
+    t.users = e.nUsers;
+    t.ulLength = e.bytes;
+    return;
+  }
+  const bool inTrigger = t.open && t.trigger == e.trigger;
+
+  if (e.kind == fairness::UL_TRACE_ALLOC)
+  {
+    if (!inTrigger)
+    {
+      s.unattributed++;
+      return;
+    }
+    t.allocated.push_back(e.sta);
+    s.ruSizes[e.ruType < kRuNames ? e.ruType : kRuNames]++;
+    return;
+  }
+
+  if (e.kind != fairness::UL_TRACE_RX || e.sta == fairness::kUlTraceNoSta)
+    return;
+  StaAcc& a = s.Sta(e.sta);
+  const bool failedInAlloc = !e.success && e.ruType != fairness::kUlTraceNone;
+  if (e.ppdu != fairness::UL_PPDU_HE_TB && !failedInAlloc)
+  {
+    // Contention-based uplink (or a drop outside any allocation)
+    if (!e.success)
+      a.otherDrop++;
+    else if (e.ppdu == fairness::UL_PPDU_HE_SU)
+      a.suOk++;
+    else
+      a.nonHeOk++;
+    return;
+  }
+  if (!inTrigger)
+  {
+    s.unattributed++;
+    return;
+  }
+  if (e.success)
+  {
+    t.tbOk++;
+    t.tbBytes += e.bytes;
+    a.tbOk++;
+    a.tbBytes += e.bytes;
+    if (e.mcs != fairness::kUlTraceNone)
+    {
+      t.mcsSum += e.mcs;
+      t.mcsCount++;
+      a.mcsSum += e.mcs;
+      a.mcsCount++;
+    }
+    if (!Contains(t.responders, e.sta))
+      t.responders.push_back(e.sta);
+  }
+  else
+  {
+    t.tbDrop++;
+    a.tbDrop++;
+  }
+}
+
+// Map one trace file and feed its events; false on I/O or format errors.
+bool ReadFile(const std::string& path, int64_t runFilter, int64_t bssFilter, const uint64_t* configFilter,
+              std::map<CellKey, TriggerAcc>& open, Summary& s, bool perTrigger)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    std::cerr << path << ": cannot open\n";
+    return false;
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(fairness::UlTraceFileHeader)))
+  {
+    std::cerr << path << ": not an uplink trace file\n";
+    ::close(fd);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+  {
+    std::cerr << path << ": mmap failed\n";
+    return false;
+  }
+  ::madvise(map, size, MADV_SEQUENTIAL);
+
+  const char* base = static_cast<const char*>(map);
+  fairness::UlTraceFileHeader h{};
+  std::memcpy(&h, base, sizeof(h));
+  bool ok = std::memcmp(h.magic, fairness::kUlTraceMagic, sizeof(h.magic)) == 0 &&
+            h.eventSize >= fairness::kUlTraceEventV1Size;
+  if (!ok)
+  {
+    std::cerr << path << ": not an uplink trace file (or unexpected event size)\n";
+  }
+  else
+  {
+    // Versions only append fields: the stride is the file's event size, and
+    // fields an older file lacks stay zero.
+    const size_t n = (size - sizeof(h)) / h.eventSize;
+    const size_t copy = std::min<size_t>(h.eventSize, sizeof(UlTraceEvent));
+    for (size_t i = 0; i < n; ++i)
+    {
+      UlTraceEvent e{};
+      std::memcpy(&e, base + sizeof(h) + i * h.eventSize, copy);
+      if ((runFilter >= 0 && e.run != runFilter) || (bssFilter >= 0 && e.bss != bssFilter) ||
+          (configFilter && e.configHash != *configFilter))
+        continue;
+      AddEvent(e, open, s, perTrigger);
+    }
+  }
+  ::munmap(map, size);
+  return ok;
+}
+
+double Ratio(uint64_t a, uint64_t b)
+{
+  return b > 0 ? double(a) / double(b) : 0.0;
+}
+
+void PrintSummary(const Summary& s)
+{
+  std::printf("# ul-trace events=%llu cells=%zu (configHash, run, bss) unattributed=%llu\n",
+              (unsigned long long)s.events, s.cells.size(), (unsigned long long)s.unattributed);
+  std::printf("Triggers: basic=%llu usersPerTrigger=%.3f respondersPerTrigger=%.3f responseRate=%.4f "
+              "empty=%llu (%.2f%%)\n",
+              (unsigned long long)s.triggers, Ratio(s.users, s.triggers), Ratio(s.responders, s.triggers),
+              Ratio(s.responders, s.users), (unsigned long long)s.emptyTriggers,
+              100.0 * Ratio(s.emptyTriggers, s.triggers));
+  std::printf("HE TB MPDUs: ok=%llu dropped=%llu successRatio=%.4f bytesPerTrigger=%.1f\n",
+              (unsigned long long)s.tbOk, (unsigned long long)s.tbDrop, Ratio(s.tbOk, s.tbOk + s.tbDrop),
+              Ratio(s.tbBytes, s.triggers));
+  std::printf("Responders per trigger:");
+  for (size_t k = 0; k < kMaxResponderBins; ++k)
+  {
+    if (s.respondersHist[k] > 0)
+      std::printf(" %zu%s:%llu", k, k + 1 == kMaxResponderBins ? "+" : "", (unsigned long long)s.respondersHist[k]);
+  }
+  std::printf("\nRU sizes allocated (tones):");
+  for (size_t k = 0; k <= kRuNames; ++k)
+  {
+    if (s.ruSizes[k] > 0)
+      std::printf(" %s:%llu", k < kRuNames ? fairness::kUlTraceRuNames[k] : "?", (unsigned long long)s.ruSizes[k]);
+  }
+  std::printf("\n%-8s %10s %10s %8s %10s %10s %12s %8s %10s %10s %10s\n", "STA", "allocated", "answered", "rate",
+              "tbOk", "tbDrop", "tbBytes", "tbMcs", "heSuOk", "nonHeOk", "otherDrop");
+  for (size_t i = 0; i < s.stas.size(); ++i)
+  {
+    const StaAcc& a = s.stas[i];
+    if (a.allocated + a.tbOk + a.tbDrop + a.suOk + a.nonHeOk + a.otherDrop == 0)
+      continue;
+    char label[32];
+    std::snprintf(label, sizeof(label), "STA[%zu]", i);
+    std::printf("%-8s %10llu %10llu %8.4f %10llu %10llu %12llu %8.2f %10llu %10llu %10llu\n", label,
+                (unsigned long long)a.allocated,
+                (unsigned long long)a.answered, Ratio(a.answered, a.allocated), (unsigned long long)a.tbOk,
+                (unsigned long long)a.tbDrop, (unsigned long long)a.tbBytes,
+                a.mcsCount ? double(a.mcsSum) / double(a.mcsCount) : -1.0, (unsigned long long)a.suOk,
+                (unsigned long long)a.nonHeOk, (unsigned long long)a.otherDrop);
+  }
+}
+
+void Usage()
+{
+  std::cerr << "usage: ul-trace-reader [--per-trigger] [--run=N] [--bss=B] [--config=HASH] file ...\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  bool perTrigger = false;
+  int64_t runFilter = -1;
+  int64_t bssFilter = -1;
+  bool hasConfigFilter = false;
+  uint64_t configFilter = 0;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--per-trigger")
+    {
+      perTrigger = true;
+    }
+    else if (arg.rfind("--run=", 0) == 0)
+    {
+      runFilter = std::strtoll(arg.c_str() + 6, nullptr, 10);
+    }
+    else if (arg.rfind("--bss=", 0) == 0)
+    {
+      bssFilter = std::strtoll(arg.c_str() + 6, nullptr, 10);
+    }
+    else if (arg.rfind("--config=", 0) == 0)
+    {
+      hasConfigFilter = true;
+      configFilter = std::strtoull(arg.c_str() + 9, nullptr, 16);
+    }
+    else if (arg == "--help" || arg == "-h")
+    {
+      Usage();
+      return 0;
+    }
+    else if (arg.rfind("--", 0) == 0)
+    {
+      Usage();
+      return 2;
+    }
+    else
+    {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty())
+  {
+    Usage();
+    return 2;
+  }
+
+  if (perTrigger)
+    std::printf("run,bss,trigger,timeNs,users,ulLength,responders,tbOk,tbDrop,tbBytes,meanMcs,configHash\n");
+  Summary summary;
+  std::map<CellKey, TriggerAcc> open;
+  bool ok = true;
+  for (const std::string& in : inputs)
+  {
+    ok = ReadFile(in, runFilter, bssFilter, hasConfigFilter ? &configFilter : nullptr, open, summary, perTrigger) && ok;
+  }
+  for (auto& [key, t] : open)
+  {
+    CloseTrigger(t, summary, perTrigger);
+  }
+  if (!perTrigger)
+    PrintSummary(summary);
+  return ok ? 0 : 1;
+}
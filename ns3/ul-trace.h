@@ -0,0 +1,214 @@
+/**
+ * AP-side uplink event capture of fairness11ax (--ulTrace=<path>), read by
+ * ul-trace-reader.
+ *
+ * A lightweight alternative to pcap for looking at trigger-based uplink:
+ * every basic trigger the AP sends, each of its RU allocations and every
+ * uplink QoS data MPDU the AP receives (or drops) become one fixed-size
+ * UlTraceEvent. Events are collected in an in-memory ring buffer and
+ * appended to the file in large chunks (one fwrite per kChunkEvents events),
+ * so tracing costs a struct copy per event and a handful of writes per run.
+ *
+ * File layout: UlTraceFileHeader, then back-to-back UlTraceEvent structs in
+ * host (little-endian) byte order; like the record files, the file can be
+ * memory-mapped and viewed as strided columns. Files are opened in append
+ * mode and shared by every run and cell of a process (events carry both, and
+ * the configHash of the run manifest, which tells apart the warm-start points
+ * of one run); a non-empty file is only appended to if its header matches
+ * this build's. Readers use UlTraceFileHeader::eventSize as the stride;
+ * version 1 events (32 bytes) end before configHash.
+ *
+ * This header has no ns-3 dependency: it is shared by the scenario and by
+ * the reader tool.
+ */
+#ifndef UL_TRACE_H
+#define UL_TRACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace fairness
+{
+
+constexpr char kUlTraceMagic[8] = {'U', 'L', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint32_t kUlTraceVersion = 2;
+constexpr uint32_t kUlTraceEventV1Size = 32; // version 1: no configHash
+
+enum UlTraceKind : uint8_t
+{
+  UL_TRACE_TRIGGER = 0, // AP sent a basic trigger (nUsers, bytes = UL Length)
+  UL_TRACE_ALLOC = 1,   // one user info of that trigger (sta, RU, MCS)
+  UL_TRACE_RX = 2,      // uplink QoS data MPDU at the AP (success, bytes)
+};
+
+enum UlTracePpdu : uint8_t
+{
+  UL_PPDU_NONE = 0,    // TRIGGER/ALLOC events
+  UL_PPDU_HE_TB = 1,
+  UL_PPDU_HE_SU = 2,   // HE SU and HE ER SU
+  UL_PPDU_NON_HE = 3,  // VHT/HT/OFDM
+  UL_PPDU_UNKNOWN = 4, // dropped MPDUs: the PHY does not report the format
+};
+
+// ruType values: ns-3 RuType order (RU_26_TONE = 0, ...); kUlTraceNone if n/a
+constexpr uint8_t kUlTraceNone = 0xff;
+constexpr uint16_t kUlTraceNoSta = 0xffff;
+constexpr const char* kUlTraceRuNames[] = {"26", "52", "106", "242", "484", "996", "2x996"};
+
+struct UlTraceFileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t eventSize;
+};
+
+// 8-byte field first, then 4-, 2- and 1-byte fields up to an 8-byte boundary,
+// then the v2 8-byte field: no padding.
+struct UlTraceEvent
+{
+  int64_t timeNs;   // simulation time
+  uint32_t run;     // RngRun (low 32 bits)
+  uint32_t trigger; // basic triggers the cell's AP has sent so far (this one included)
+  uint32_t bytes;   // RX: MPDU size; TRIGGER: UL Length field; ALLOC: 0
+  uint16_t sta;     // STA index (legacy first, then HE); kUlTraceNoSta for TRIGGER
+  uint16_t bss;     // cell
+  uint8_t kind;     // UlTraceKind
+  uint8_t ppdu;     // UlTracePpdu
+  uint8_t ruType;   // RU size (see kUlTraceRuNames)
+  uint8_t ruIndex;  // RU index within its size (1-based)
+  uint8_t mcs;      // HT/VHT/HE MCS; kUlTraceNone for non-HT rates
+  uint8_t success;  // RX: 1 received, 0 dropped by the PHY
+  uint8_t reason;   // RX dropped: WifiPhyRxfailureReason
+  uint8_t nUsers;   // TRIGGER: user info fields (saturates at 255)
+  // v2
+  uint64_t configHash; // run manifest configHash (the point's, with --warmStartPoints)
+};
+
+static_assert(sizeof(UlTraceEvent) == 40, "UlTraceEvent must not contain padding");
+
+/**
+ * Ring buffer of events in front of the trace file.
+ *
+ * keepLast = 0 streams every event: the ring is written out whenever it is
+ * full (kChunkEvents events per write) and at Flush(). keepLast = N keeps
+ * the most recent N events only (flight recorder) and writes them, oldest
+ * first, at Flush(); older events are overwritten and counted in
+ * GetOverwritten(). fairness11ax flushes at the end of every replication.
+ */
+class UlTraceWriter
+{
+public:
+  static constexpr size_t kChunkEvents = 1 << 16; // 2 MiB
+
+  UlTraceWriter() = default;
+  UlTraceWriter(const UlTraceWriter&) = delete;
+  UlTraceWriter& operator=(const UlTraceWriter&) = delete;
+
+  ~UlTraceWriter()
+  {
+    Close();
+  }
+
+  // Returns false if the file cannot be opened, or if it is not empty and its
+  // header is not this build's (another version or event size).
+  bool Open(const std::string& path, size_t keepLast)
+  {
+    m_keepLast = keepLast > 0;
+    m_ring.resize(keepLast > 0 ? keepLast : kChunkEvents);
+    m_file = std::fopen(path.c_str(), "ab");
+    if (!m_file)
+      return false;
+    // Unbuffered: each chunk reaches the file as one write.
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+    UlTraceFileHeader h{};
+    std::memcpy(h.magic, kUlTraceMagic, sizeof(h.magic));
+    h.version = kUlTraceVersion;
+    h.eventSize = sizeof(UlTraceEvent);
+    std::fseek(m_file, 0, SEEK_END);
+    if (std::ftell(m_file) == 0)
+    {
+      std::fwrite(&h, sizeof(h), 1, m_file);
+      return true;
+    }
+
+    UlTraceFileHeader found{};
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    const bool ok = in && std::fread(&found, sizeof(found), 1, in) == 1 && std::memcmp(&found, &h, sizeof(h)) == 0;
+    if (in)
+      std::fclose(in);
+    if (!ok)
+    {
+      std::fclose(m_file);
+      m_file = nullptr;
+    }
+    return ok;
+  }
+
+  bool IsOpen() const
+  {
+    return m_file != nullptr;
+  }
+
+  void Add(const UlTraceEvent& e)
+  {
+    m_ring[m_head] = e;
+    m_head = (m_head + 1 == m_ring.size()) ? 0 : m_head + 1;
+    if (m_count < m_ring.size())
+      m_count++;
+    else
+      m_overwritten++;
+    if (!m_keepLast && m_count == m_ring.size())
+      Flush();
+  }
+
+  // Write the buffered events, oldest first, and empty the ring.
+  void Flush()
+  {
+    if (!m_file || m_count == 0)
+      return;
+    const size_t tail = (m_head + m_ring.size() - m_count) % m_ring.size();
+    const size_t first = std::min(m_count, m_ring.size() - tail);
+    std::fwrite(m_ring.data() + tail, sizeof(UlTraceEvent), first, m_file);
+    std::fwrite(m_ring.data(), sizeof(UlTraceEvent), m_count - first, m_file);
+    m_written += m_count;
+    m_head = 0;
+    m_count = 0;
+  }
+
+  uint64_t GetWritten() const
+  {
+    return m_written;
+  }
+
+  uint64_t GetOverwritten() const
+  {
+    return m_overwritten;
+  }
+
+  void Close()
+  {
+    if (!m_file)
+      return;
+    Flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+
+private:
+  std::FILE* m_file{nullptr};
+  bool m_keepLast{false};
+  std::vector<UlTraceEvent> m_ring;
+  size_t m_head{0};
+  size_t m_count{0};
+  uint64_t m_written{0};
+  uint64_t m_overwritten{0};
+};
+
+} // namespace fairness
+
+#endif /* UL_TRACE_H */
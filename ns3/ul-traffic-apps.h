@@ -0,0 +1,587 @@
+/**
+ * Uplink traffic generators shared by the fairness11ax scenario and the
+ * ul-traffic-bench microbenchmark: Poisson arrivals (PoissonUdpApp), a
+ * queue-driven saturated source (SaturatedUdpApp) and the AP-side sink that
+ * demultiplexes all of them on one port (UplinkDemuxSink).
+ *
+ * Include from exactly one translation unit per program: the timestamp tag
+ * registers its TypeId here.
+ */
+#ifndef UL_TRAFFIC_APPS_H
+#define UL_TRAFFIC_APPS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Byte tag carried by every uplink packet: per-app sequence number, the
+ * time the application handed it to the socket, the access category of its
+ * flow (AcIndex, AC_BE for the default flow) and the flow itself (0 for the
+ * default flow, 1 + f for --flows entry f). Byte tags survive A-MPDU
+ * aggregation and header removal, so the AP sink sees the original stamp.
+ */
+class UplinkTimestampTag : public Tag
+{
+public:
+  static TypeId GetTypeId()
+  {
+    static TypeId tid = TypeId("ns3::UplinkTimestampTag")
+                          .SetParent<Tag>()
+                          .AddConstructor<UplinkTimestampTag>();
+    return tid;
+  }
+
+  TypeId GetInstanceTypeId() const override
+  {
+    return GetTypeId();
+  }
+
+  uint32_t GetSerializedSize() const override
+  {
+    return 4 + 8 + 1 + 1;
+  }
+
+  void Serialize(TagBuffer i) const override
+  {
+    i.WriteU32(m_seq);
+    i.WriteU64(static_cast<uint64_t>(m_txTimeNs));
+    i.WriteU8(m_ac);
+    i.WriteU8(m_flow);
+  }
+
+  void Deserialize(TagBuffer i) override
+  {
+    m_seq = i.ReadU32();
+    m_txTimeNs = static_cast<int64_t>(i.ReadU64());
+    m_ac = i.ReadU8();
+    m_flow = i.ReadU8();
+  }
+
+  void Print(std::ostream& os) const override
+  {
+    os << "seq=" << m_seq << " tx=" << m_txTimeNs << "ns ac=" << unsigned(m_ac) << " flow=" << unsigned(m_flow);
+  }
+
+  void Set(uint32_t seq, Time txTime, uint8_t ac = 0, uint8_t flow = 0)
+  {
+    m_seq = seq;
+    m_txTimeNs = txTime.GetNanoSeconds();
+    m_ac = ac;
+    m_flow = flow;
+  }
+
+  uint32_t GetSeq() const
+  {
+    return m_seq;
+  }
+
+  Time GetTxTime() const
+  {
+    return NanoSeconds(m_txTimeNs);
+  }
+
+  uint8_t GetAc() const
+  {
+    return m_ac;
+  }
+
+  uint8_t GetFlow() const
+  {
+    return m_flow;
+  }
+
+private:
+  uint32_t m_seq{0};
+  int64_t m_txTimeNs{0};
+  uint8_t m_ac{0};
+  uint8_t m_flow{0};
+};
+
+NS_OBJECT_ENSURE_REGISTERED(UplinkTimestampTag);
+
+// How PoissonUdpApp produces the packet of each send
+enum class PayloadMode
+{
+  ALLOC,    // Create<Packet>(size) per packet (original behaviour)
+  TEMPLATE, // Copy() of one preallocated zero-filled packet (shared buffer, copy-on-write)
+};
+
+/**
+ * Simple Poisson UDP uplink generator:
+ * inter-arrival ~ Exp(lambda), constant packet size, sends to AP:port
+ *
+ * SetArrivalBatch(k) draws the next k inter-arrival times in one pass over
+ * the RNG; the values (and hence the simulation) are identical to k = 1.
+ *
+ * Optional, for heterogeneous traffic (their RNGs are only created when
+ * used, so a default app draws exactly the same numbers as before):
+ *   - SetSizeRange(min, max): packet size uniform in [min, max] bytes
+ *   - SetOnOff(meanOn, meanOff): exponential ON/OFF periods (starting ON)
+ *     with Poisson arrivals during ON only, i.e. a two-state MMPP
+ *   - SetAc(ac): access category written into the timestamp tag; the
+ *     scenario maps the socket priority to the same AC
+ *   - SetFlow(flow): flow index written into the timestamp tag
+ */
+class PoissonUdpApp : public Application
+{
+public:
+  PoissonUdpApp() = default;
+
+  void Setup(Ptr<Socket> socket,
+             Address peer,
+             uint32_t pktSize,
+             double lambdaPktsPerSec,
+             uint64_t maxPackets = 0 /*0 => unlimited*/)
+  {
+    m_socket = socket;
+    m_peer = peer;
+    m_pktSize = pktSize;
+    m_lambda = lambdaPktsPerSec;
+    m_maxPackets = maxPackets;
+    m_sent = 0;
+    m_running = false;
+    m_rng = CreateObject<ExponentialRandomVariable>();
+    if (m_lambda > 0.0)
+    {
+      m_rng->SetAttribute("Mean", DoubleValue(1.0 / m_lambda));
+    }
+  }
+
+  void SetPayloadMode(PayloadMode mode)
+  {
+    m_payloadMode = mode;
+  }
+
+  void SetArrivalBatch(uint32_t k)
+  {
+    m_dtBatch.assign(k > 0 ? k : 1, 0.0);
+    m_dtNext = m_dtBatch.size();
+  }
+
+  void SetSizeRange(uint32_t minSize, uint32_t maxSize)
+  {
+    m_pktSize = maxSize;
+    m_minSize = minSize;
+    if (minSize < maxSize)
+    {
+      m_sizeRng = CreateObject<UniformRandomVariable>();
+    }
+  }
+
+  void SetOnOff(Time meanOn, Time meanOff)
+  {
+    if (!meanOn.IsStrictlyPositive() || !meanOff.IsStrictlyPositive())
+      return;
+    m_onRng = CreateObject<ExponentialRandomVariable>();
+    m_onRng->SetAttribute("Mean", DoubleValue(meanOn.GetSeconds()));
+    m_offRng = CreateObject<ExponentialRandomVariable>();
+    m_offRng->SetAttribute("Mean", DoubleValue(meanOff.GetSeconds()));
+  }
+
+  void SetAc(uint8_t ac)
+  {
+    m_ac = ac;
+  }
+
+  void SetFlow(uint8_t flow)
+  {
+    m_flow = flow;
+  }
+
+  // Streams reserved by AssignStreams()
+  static constexpr int64_t kNumStreams = 4;
+
+  /**
+   * Fix the streams of the app's random variables (inter-arrival, size,
+   * on and off periods, in that order) to stream..stream+3. Call after
+   * Setup/SetSizeRange/SetOnOff. Always reserves kNumStreams, whether or not
+   * the variable is in use, so that a caller's layout does not depend on the
+   * traffic options.
+   */
+  int64_t AssignStreams(int64_t stream)
+  {
+    m_rng->SetStream(stream);
+    if (m_sizeRng)
+      m_sizeRng->SetStream(stream + 1);
+    if (m_onRng)
+    {
+      m_onRng->SetStream(stream + 2);
+      m_offRng->SetStream(stream + 3);
+    }
+    return kNumStreams;
+  }
+
+  uint64_t GetSent() const
+  {
+    return m_sent;
+  }
+
+private:
+  void StartApplication() override
+  {
+    m_running = true;
+    m_socket->Bind();
+    m_socket->Connect(m_peer);
+    if (m_payloadMode == PayloadMode::TEMPLATE && !m_template)
+    {
+      m_template = Create<Packet>(m_pktSize);
+    }
+    if (m_onRng)
+    {
+      m_on = true;
+      m_toggleEvent = Simulator::Schedule(Seconds(m_onRng->GetValue()), &PoissonUdpApp::Toggle, this);
+    }
+    ScheduleNext();
+  }
+
+  void StopApplication() override
+  {
+    m_running = false;
+    if (m_sendEvent.IsPending())
+    {
+      Simulator::Cancel(m_sendEvent);
+    }
+    if (m_toggleEvent.IsPending())
+    {
+      Simulator::Cancel(m_toggleEvent);
+    }
+    if (m_socket)
+    {
+      m_socket->Close();
+    }
+  }
+
+  void SendOnce()
+  {
+    if (!m_running)
+      return;
+
+    if (m_maxPackets != 0 && m_sent >= m_maxPackets)
+      return;
+
+    const uint32_t size = m_sizeRng ? m_sizeRng->GetInteger(m_minSize, m_pktSize) : m_pktSize;
+    Ptr<Packet> p;
+    if (m_payloadMode == PayloadMode::TEMPLATE)
+      p = (size == m_pktSize) ? m_template->Copy() : m_template->CreateFragment(0, size);
+    else
+      p = Create<Packet>(size);
+    UplinkTimestampTag tag;
+    tag.Set(static_cast<uint32_t>(m_sent), Simulator::Now(), m_ac, m_flow);
+    p->AddByteTag(tag);
+    m_socket->Send(p);
+    m_sent++;
+
+    ScheduleNext();
+  }
+
+  // End of an ON (pending arrival dropped; memoryless) or OFF period
+  void Toggle()
+  {
+    m_on = !m_on;
+    if (m_on)
+    {
+      ScheduleNext();
+    }
+    else if (m_sendEvent.IsPending())
+    {
+      Simulator::Cancel(m_sendEvent);
+    }
+    Ptr<ExponentialRandomVariable> period = m_on ? m_onRng : m_offRng;
+    m_toggleEvent = Simulator::Schedule(Seconds(period->GetValue()), &PoissonUdpApp::Toggle, this);
+  }
+
+  double NextInterArrival()
+  {
+    if (m_dtBatch.size() <= 1)
+      return m_rng->GetValue();
+
+    if (m_dtNext == m_dtBatch.size())
+    {
+      for (double& dt : m_dtBatch)
+      {
+        dt = m_rng->GetValue();
+      }
+      m_dtNext = 0;
+    }
+    return m_dtBatch[m_dtNext++];
+  }
+
+  void ScheduleNext()
+  {
+    if (!m_running)
+      return;
+
+    if (m_lambda <= 0.0 || !m_on)
+      return;
+
+    const double dt = NextInterArrival(); // seconds
+    m_sendEvent = Simulator::Schedule(Seconds(dt), &PoissonUdpApp::SendOnce, this);
+  }
+
+private:
+  Ptr<Socket> m_socket;
+  Address m_peer;
+  uint32_t m_pktSize{1200};
+  double m_lambda{100.0};
+  uint64_t m_maxPackets{0};
+  uint64_t m_sent{0};
+  bool m_running{false};
+  EventId m_sendEvent;
+  Ptr<ExponentialRandomVariable> m_rng;
+
+  PayloadMode m_payloadMode{PayloadMode::ALLOC};
+  Ptr<Packet> m_template;
+  std::vector<double> m_dtBatch; // pre-drawn inter-arrival times (s)
+  size_t m_dtNext{0};
+
+  uint32_t m_minSize{0};
+  Ptr<UniformRandomVariable> m_sizeRng; // null: constant m_pktSize
+  Ptr<ExponentialRandomVariable> m_onRng; // null: always on
+  Ptr<ExponentialRandomVariable> m_offRng;
+  bool m_on{true};
+  EventId m_toggleEvent;
+  uint8_t m_ac{0};
+  uint8_t m_flow{0};
+};
+
+/**
+ * Saturated UDP uplink source: keeps a target number of its own packets in
+ * the STA's MAC queue instead of offering a fixed rate.
+ *
+ * The app is MAC-agnostic; the scenario reports every one of its packets
+ * leaving the queue (acked, dropped after retries or expired) through
+ * NotifyLeftQueue(), typically from the queue's Dequeue trace. Refills are
+ * deferred with ScheduleNow() so the queue is never modified from within its
+ * own trace, and coalesced so one event tops up many departures. Packets
+ * the queue rejects when full (a byte cap, or other flows sharing it) are
+ * reported through NotifyRejected(): refilling then pauses until the next
+ * departure, so the app keeps a capped queue full instead of retrying.
+ *
+ * Only one packet is sent at start: until ARP has resolved the AP, packets
+ * wait in the ARP pending queue (3 packets by default) and would be dropped
+ * there. The first departure means the path is up; the queue is then filled
+ * to the target depth.
+ */
+class SaturatedUdpApp : public Application
+{
+public:
+  SaturatedUdpApp() = default;
+
+  void Setup(Ptr<Socket> socket, Address peer, uint32_t pktSize, uint32_t targetDepth)
+  {
+    m_socket = socket;
+    m_peer = peer;
+    m_pktSize = pktSize;
+    m_target = targetDepth > 0 ? targetDepth : 1;
+    m_sent = 0;
+    m_inQueue = 0;
+    m_running = false;
+    m_pathUp = false;
+    m_queueFull = false;
+  }
+
+  void SetPayloadMode(PayloadMode mode)
+  {
+    m_payloadMode = mode;
+  }
+
+  uint64_t GetSent() const
+  {
+    return m_sent;
+  }
+
+  // One of this app's packets has left the MAC queue.
+  void NotifyLeftQueue()
+  {
+    if (m_inQueue > 0)
+      m_inQueue--;
+    m_pathUp = true;
+    m_queueFull = false;
+    if (m_running && !m_refillEvent.IsPending())
+    {
+      m_refillEvent = Simulator::ScheduleNow(&SaturatedUdpApp::Refill, this);
+    }
+  }
+
+  // One of this app's packets was rejected by the full MAC queue (called
+  // from within Send(), so no refill here).
+  void NotifyRejected()
+  {
+    if (m_inQueue > 0)
+      m_inQueue--;
+    m_queueFull = true;
+  }
+
+private:
+  void StartApplication() override
+  {
+    m_running = true;
+    m_socket->Bind();
+    m_socket->Connect(m_peer);
+    if (m_payloadMode == PayloadMode::TEMPLATE && !m_template)
+    {
+      m_template = Create<Packet>(m_pktSize);
+    }
+    if (m_inQueue == 0)
+    {
+      SendOne();
+    }
+  }
+
+  void StopApplication() override
+  {
+    m_running = false;
+    if (m_refillEvent.IsPending())
+    {
+      Simulator::Cancel(m_refillEvent);
+    }
+    if (m_socket)
+    {
+      m_socket->Close();
+    }
+  }
+
+  void Refill()
+  {
+    if (!m_running)
+      return;
+
+    const uint32_t target = m_pathUp ? m_target : 1;
+    while (m_inQueue < target && !m_queueFull)
+    {
+      SendOne();
+    }
+  }
+
+  void SendOne()
+  {
+    Ptr<Packet> p = (m_payloadMode == PayloadMode::TEMPLATE) ? m_template->Copy() : Create<Packet>(m_pktSize);
+    UplinkTimestampTag tag;
+    tag.Set(static_cast<uint32_t>(m_sent), Simulator::Now());
+    p->AddByteTag(tag);
+    m_socket->Send(p);
+    m_sent++;
+    m_inQueue++;
+  }
+
+private:
+  Ptr<Socket> m_socket;
+  Address m_peer;
+  uint32_t m_pktSize{1200};
+  uint32_t m_target{128};
+  uint64_t m_sent{0};
+  uint32_t m_inQueue{0}; // sent and not yet reported as having left the MAC queue
+  bool m_running{false};
+  bool m_pathUp{false};
+  bool m_queueFull{false}; // last send rejected; wait for a departure
+  EventId m_refillEvent;
+
+  PayloadMode m_payloadMode{PayloadMode::ALLOC};
+  Ptr<Packet> m_template;
+};
+
+/**
+ * Single UDP sink for all uplink flows. Instead of one PacketSink and one
+ * port per STA, every STA sends to the same port and the sender index is
+ * recovered from the source address: STAs must hold consecutive addresses
+ * starting at firstSta, so the lookup is a subtraction and a bounds check.
+ * Per-STA byte and packet counters are kept as flat arrays; the optional
+ * callback sees every packet accepted for a STA with that STA's index.
+ */
+class UplinkDemuxSink : public Application
+{
+public:
+  UplinkDemuxSink() = default;
+
+  void Setup(Ptr<Socket> socket, uint16_t port, Ipv4Address firstSta, uint32_t nSta)
+  {
+    m_socket = socket;
+    m_port = port;
+    m_first = firstSta.Get();
+    m_rxBytes.assign(nSta, 0);
+    m_rxPackets.assign(nSta, 0);
+    m_unknown = 0;
+  }
+
+  // Called as cb(staIndex, packet) for every packet attributed to a STA
+  void SetRxCallback(Callback<void, uint32_t, Ptr<const Packet>> cb)
+  {
+    m_rxCallback = cb;
+  }
+
+  const std::vector<uint64_t>& GetRxBytes() const
+  {
+    return m_rxBytes;
+  }
+
+  const std::vector<uint64_t>& GetRxPackets() const
+  {
+    return m_rxPackets;
+  }
+
+  // Packets from addresses outside [firstSta, firstSta + nSta)
+  uint64_t GetUnknownRx() const
+  {
+    return m_unknown;
+  }
+
+private:
+  void StartApplication() override
+  {
+    m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+    m_socket->SetRecvCallback(MakeCallback(&UplinkDemuxSink::HandleRead, this));
+  }
+
+  void StopApplication() override
+  {
+    if (m_socket)
+    {
+      m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+      m_socket->Close();
+    }
+  }
+
+  void HandleRead(Ptr<Socket> socket)
+  {
+    Address from;
+    while (Ptr<Packet> p = socket->RecvFrom(from))
+    {
+      if (!InetSocketAddress::IsMatchingType(from))
+      {
+        m_unknown++;
+        continue;
+      }
+      // Unsigned wrap-around maps addresses below firstSta out of range too.
+      const uint32_t sta = InetSocketAddress::ConvertFrom(from).GetIpv4().Get() - m_first;
+      if (sta >= m_rxBytes.size())
+      {
+        m_unknown++;
+        continue;
+      }
+      m_rxBytes[sta] += p->GetSize();
+      m_rxPackets[sta]++;
+      if (!m_rxCallback.IsNull())
+      {
+        m_rxCallback(sta, p);
+      }
+    }
+  }
+
+private:
+  Ptr<Socket> m_socket;
+  uint16_t m_port{0};
+  uint32_t m_first{0};
+  std::vector<uint64_t> m_rxBytes;
+  std::vector<uint64_t> m_rxPackets;
+  uint64_t m_unknown{0};
+  Callback<void, uint32_t, Ptr<const Packet>> m_rxCallback;
+};
+
+} // namespace ns3
+
+#endif /* UL_TRAFFIC_APPS_H */
@@ -0,0 +1,112 @@
+/**
+ * Microbenchmark for the uplink generator of fairness11ax.
+ *
+ * nSta nodes run PoissonUdpApp towards one sink node over a SimpleChannel
+ * (no Wi-Fi), so the wall time is dominated by packet generation, event
+ * scheduling and the UDP/IP stack. Compare --payloadMode and --arrivalBatch:
+ *
+ *   ./ns3 run "scratch/ul-traffic-bench --payloadMode=alloc"
+ *   ./ns3 run "scratch/ul-traffic-bench --payloadMode=template --arrivalBatch=64"
+ *
+ * Prints one "bench ..." line with simulated events/s and packets/s.
+ */
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+
+#include "ul-traffic-apps.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("UlTrafficBench");
+
+int main(int argc, char* argv[])
+{
+  uint32_t nSta = 10;
+  double lambda = 5000.0; // pkts/s per STA
+  double simTime = 10.0;  // s
+  uint32_t payloadSize = 1000;
+  std::string payloadMode = "alloc";
+  uint32_t arrivalBatch = 1;
+
+  CommandLine cmd(__FILE__);
+  cmd.AddValue("nSta", "Number of generating nodes", nSta);
+  cmd.AddValue("lambda", "Packets/s per node", lambda);
+  cmd.AddValue("simTime", "Simulated seconds of traffic", simTime);
+  cmd.AddValue("payloadSize", "UDP payload size (bytes)", payloadSize);
+  cmd.AddValue("payloadMode", "alloc or template", payloadMode);
+  cmd.AddValue("arrivalBatch", "Inter-arrival times drawn per RNG pass", arrivalBatch);
+  cmd.Parse(argc, argv);
+
+  NS_ABORT_MSG_IF(payloadMode != "alloc" && payloadMode != "template",
+                  "Unknown --payloadMode=" << payloadMode << " (expected alloc or template)");
+
+  // ---- Nodes / devices ----
+  NodeContainer sinkNode;
+  sinkNode.Create(1);
+  NodeContainer stas;
+  stas.Create(nSta);
+
+  NodeContainer all;
+  all.Add(sinkNode);
+  all.Add(stas);
+
+  SimpleNetDeviceHelper link;
+  NetDeviceContainer devs = link.Install(all);
+
+  InternetStackHelper stack;
+  stack.Install(all);
+
+  Ipv4AddressHelper addr;
+  addr.SetBase("10.2.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer ifs = addr.Assign(devs);
+
+  // ---- Apps ----
+  const uint16_t port = 9;
+  PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+  ApplicationContainer sinkApp = sinkHelper.Install(sinkNode.Get(0));
+  sinkApp.Start(Seconds(0.0));
+  sinkApp.Stop(Seconds(1.0 + simTime + 0.1));
+
+  std::vector<Ptr<PoissonUdpApp>> apps(nSta);
+  for (uint32_t i = 0; i < nSta; ++i)
+  {
+    Ptr<Node> sta = stas.Get(i);
+    Ptr<Socket> sock = Socket::CreateSocket(sta, UdpSocketFactory::GetTypeId());
+    apps[i] = CreateObject<PoissonUdpApp>();
+    apps[i]->Setup(sock, InetSocketAddress(ifs.GetAddress(0), port), payloadSize, lambda);
+    apps[i]->SetPayloadMode(payloadMode == "template" ? PayloadMode::TEMPLATE : PayloadMode::ALLOC);
+    apps[i]->SetArrivalBatch(arrivalBatch);
+    sta->AddApplication(apps[i]);
+    apps[i]->SetStartTime(Seconds(1.0));
+    apps[i]->SetStopTime(Seconds(1.0 + simTime));
+  }
+
+  // ---- Run ----
+  Simulator::Stop(Seconds(1.0 + simTime + 0.2));
+  const auto t0 = std::chrono::steady_clock::now();
+  Simulator::Run();
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  uint64_t sent = 0;
+  for (const auto& app : apps)
+  {
+    sent += app->GetSent();
+  }
+  const uint64_t events = Simulator::GetEventCount();
+  const uint64_t rx = DynamicCast<PacketSink>(sinkApp.Get(0))->GetTotalRx();
+
+  std::printf("bench payloadMode=%s arrivalBatch=%u nSta=%u lambda=%g simTime=%g "
+              "events=%llu sent=%llu rxBytes=%llu wall=%.3fs events/s=%.0f pkts/s=%.0f\n",
+              payloadMode.c_str(), arrivalBatch, nSta, lambda, simTime, (unsigned long long)events,
+              (unsigned long long)sent, (unsigned long long)rx, wall, wall > 0 ? events / wall : 0.0,
+              wall > 0 ? sent / wall : 0.0);
+
+  Simulator::Destroy();
+  return 0;
+}
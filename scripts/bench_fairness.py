@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""
+Reference benchmark of fairness11ax: where a run spends its time, and
+whether that changed.
+
+Runs the fixed reference scenarios (nL2/mH8, nL5/mH5, nL8/mH2 at mu=0 and
+mu=0.01, one RngRun each) with --profileCallbacks and reports per scenario:
+
+    wall time, simulated events, events/s, peak RSS, and the share of the
+    run spent in each group of the scenario's own callbacks (queue,
+    failures, tb, airtime, ap, latency, traffic, control); the remainder is
+    ns-3 itself.
+
+With --perf (Linux perf on PATH), every scenario is also sampled once under
+`perf record` and the ns-3 remainder is split by symbol into scheduler,
+phy (spectrum PHY, interference, error models), mac, mu_scheduler,
+callbacks and other.
+
+--save FILE writes the results as a baseline JSON (with the binary hash,
+ns-3 version and host); --baseline FILE compares against one and exits 1
+when events/s dropped by more than --tolerance in any scenario. A changed
+event count means the scenario itself changed, not just its speed.
+
+Example:
+
+    python3 scripts/bench_fairness.py --ns3-dir ~/ns-3.46 --save bench-baseline.json
+    python3 scripts/bench_fairness.py --ns3-dir ~/ns-3.46 --baseline bench-baseline.json
+"""
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List, Optional
+
+import sweep
+
+REFERENCE = [(nl, mh, mu) for (nl, mh) in [(2, 8), (5, 5), (8, 2)] for mu in ["0", "0.01"]]
+
+PERF_RE = re.compile(r"Perf: nTotal=(\d+) setupWall=([0-9.eE+-]+)s runWall=([0-9.eE+-]+)s "
+                     r"events=(\d+) events/s=([0-9.eE+-]+) maxRss=(\d+) KB")
+PROFILE_GROUP_RE = re.compile(r" (\w+)=([0-9.eE+-]+)s/(\d+)")
+
+# ns-3 symbol groups for --perf, first match wins
+SYMBOL_GROUPS = [
+    ("callbacks", re.compile(r"\b(On[A-Z]\w*|SampleQueue|AccumulateQueueArea|WarmupSample|IntervalTick|"
+                             r"CwControlStep|ObserveGroups|CallbackTimer)\b")),
+    ("mu_scheduler", re.compile(r"MultiUserScheduler")),
+    ("scheduler", re.compile(r"Simulator|MapScheduler|HeapScheduler|ListScheduler|CalendarScheduler|"
+                             r"EventImpl|EventId|Scheduler::")),
+    ("phy", re.compile(r"Phy|Interference|Spectrum|Propagation|ErrorRate|Nist|Yans|TableBased|PhyEntity|"
+                       r"Ppdu|Signal")),
+    ("mac", re.compile(r"Mac|Txop|FrameExchange|BlockAck|RemoteStation|Mpdu|Psdu|ChannelAccess|"
+                       r"Wifi")),
+]
+
+
+def scenario_name(nl: int, mh: int, mu: str) -> str:
+    return f"nL{nl}_mH{mh}_mu{mu}"
+
+
+def scenario_args(args: argparse.Namespace, nl: int, mh: int, mu: str) -> List[str]:
+    return [
+        f"--nLegacy={nl}",
+        f"--mHe={mh}",
+        f"--simTime={args.simTime}",
+        f"--payloadSize={args.payloadSize}",
+        f"--lambdaLegacy={args.lambda_sta}",
+        f"--lambdaHe={args.lambda_sta}",
+        f"--muAccessReqInterval={mu}",
+        f"--RngRun={args.run}",
+        "--profileCallbacks=true",
+    ] + args.extra_args
+
+
+def run_once(args: argparse.Namespace, argv: List[str]) -> dict:
+    proc = subprocess.run([args.binary] + argv, cwd=args.ns3_dir, stdout=subprocess.PIPE,
+                          stderr=subprocess.PIPE, text=True)
+    if proc.returncode != 0:
+        raise RuntimeError(f"exit code {proc.returncode}: {proc.stderr.strip()[-500:]}")
+    m = PERF_RE.search(proc.stdout)
+    prof = next((l for l in proc.stdout.splitlines() if l.startswith("Profile: ")), None)
+    if not m or prof is None:
+        raise RuntimeError("no Perf/Profile line in output (binary without --profileCallbacks?)")
+    run_wall = float(m.group(3))
+    groups = {g: {"seconds": float(sec), "calls": int(calls)} for g, sec, calls in PROFILE_GROUP_RE.findall(prof)}
+    return {
+        "setup_wall_s": float(m.group(2)),
+        "run_wall_s": run_wall,
+        "events": int(m.group(4)),
+        "events_per_s": float(m.group(5)),
+        "max_rss_kb": int(m.group(6)),
+        "callbacks": groups,
+    }
+
+
+def perf_breakdown(args: argparse.Namespace, argv: List[str]) -> Optional[Dict[str, float]]:
+    """Share (percent of samples) of every symbol group, or None without perf."""
+    perf = shutil.which("perf")
+    if not perf:
+        return None
+    with tempfile.TemporaryDirectory() as tmp:
+        data = os.path.join(tmp, "perf.data")
+        rec = subprocess.run([perf, "record", "-q", "-F", str(args.perf_freq), "-o", data, "--", args.binary] + argv,
+                             cwd=args.ns3_dir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+        if rec.returncode != 0:
+            print(f"perf record failed: {rec.stderr.strip()[-300:]}", file=sys.stderr)
+            return None
+        rep = subprocess.run([perf, "report", "-i", data, "--stdio", "--no-children", "--sort", "symbol"],
+                             stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+    shares = {name: 0.0 for name, _ in SYMBOL_GROUPS}
+    shares["other"] = 0.0
+    for line in rep.stdout.splitlines():
+        m = re.match(r"\s*([0-9.]+)%\s+\[[.kH]\]\s+(.*)", line)
+        if not m:
+            continue
+        pct, sym = float(m.group(1)), m.group(2)
+        group = next((name for name, rx in SYMBOL_GROUPS if rx.search(sym)), "other")
+        shares[group] += pct
+    return {k: round(v, 2) for k, v in shares.items()}
+
+
+def bench_scenario(args: argparse.Namespace, nl: int, mh: int, mu: str) -> dict:
+    argv = scenario_args(args, nl, mh, mu)
+    reps = [run_once(args, argv) for _ in range(args.repeat)]
+    events = {r["events"] for r in reps}
+    if len(events) != 1:
+        print(f"warning: {scenario_name(nl, mh, mu)}: event count differs between repeats {sorted(events)}",
+              file=sys.stderr)
+    # Median repeat by run wall time: timings of the same run, not averaged
+    best = sorted(reps, key=lambda r: r["run_wall_s"])[len(reps) // 2]
+    wall = best["run_wall_s"]
+    out = dict(best)
+    out["run_wall_s_all"] = [r["run_wall_s"] for r in reps]
+    out["run_wall_s_stdev"] = statistics.stdev(out["run_wall_s_all"]) if len(reps) > 1 else 0.0
+    cb_total = sum(g["seconds"] for g in best["callbacks"].values())
+    out["share"] = {g: (v["seconds"] / wall if wall > 0 else 0.0) for g, v in best["callbacks"].items()}
+    out["share"]["ns3"] = max(0.0, 1.0 - cb_total / wall) if wall > 0 else 0.0
+    if args.perf:
+        out["perf_percent"] = perf_breakdown(args, argv)
+    return out
+
+
+def compare(baseline: dict, current: dict, tolerance: float) -> int:
+    regressions = 0
+    for name, cur in current["scenarios"].items():
+        base = baseline.get("scenarios", {}).get(name)
+        if base is None:
+            print(f"{name:<18} not in baseline")
+            continue
+        ratio = cur["events_per_s"] / base["events_per_s"] if base["events_per_s"] > 0 else float("inf")
+        notes = []
+        if cur["events"] != base["events"]:
+            notes.append(f"events {base['events']} -> {cur['events']} (scenario changed)")
+        if ratio < 1.0 - tolerance:
+            notes.append("REGRESSION")
+            regressions += 1
+        line = (f"{name:<18} events/s {base['events_per_s']:>12.0f} -> {cur['events_per_s']:>12.0f} "
+                f"({(ratio - 1.0) * 100:+.1f}%)  rss {base['max_rss_kb']} -> {cur['max_rss_kb']} KB  "
+                + "  ".join(notes))
+        print(line.rstrip())
+    for key in ("binary_sha256", "ns3", "host"):
+        if baseline.get("meta", {}).get(key) != current["meta"].get(key):
+            print(f"note: {key} differs from the baseline")
+    return regressions
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Profile fairness11ax on fixed reference scenarios.")
+    ap.add_argument("--ns3-dir", default=".", help="ns-3 root directory (working directory of every run)")
+    ap.add_argument("--binary", default=None,
+                    help="fairness11ax executable (default: search <ns3-dir>/build/scratch)")
+    ap.add_argument("--simTime", type=float, default=2.0)
+    ap.add_argument("--payloadSize", type=int, default=1000)
+    ap.add_argument("--lambda", dest="lambda_sta", type=float, default=5000, help="Packets/s per STA")
+    ap.add_argument("--run", type=int, default=1, help="RngRun of every scenario")
+    ap.add_argument("--repeat", type=int, default=3, help="Runs per scenario (the median run is kept)")
+    ap.add_argument("--perf", action="store_true", help="Also split the ns-3 time by symbol with Linux perf")
+    ap.add_argument("--perf-freq", type=int, default=999, help="perf sampling frequency (Hz)")
+    ap.add_argument("--save", default=None, help="Write the results as a baseline JSON")
+    ap.add_argument("--baseline", default=None, help="Compare against this baseline JSON")
+    ap.add_argument("--tolerance", type=float, default=0.10,
+                    help="Relative events/s drop that counts as a regression")
+    ap.add_argument("--extra-args", nargs=argparse.REMAINDER, default=[],
+                    help="Remaining arguments are passed verbatim to fairness11ax")
+    args = ap.parse_args()
+
+    args.ns3_dir = os.path.abspath(args.ns3_dir)
+    if args.binary is None:
+        args.binary = sweep.find_binary(args.ns3_dir)
+    if not args.binary:
+        print("fairness11ax binary not found; build it or pass --binary", file=sys.stderr)
+        return 2
+    args.binary = os.path.abspath(args.binary)
+    if args.repeat < 1:
+        ap.error("--repeat must be >= 1")
+
+    result = {
+        "meta": {
+            "date": datetime.datetime.now().isoformat(timespec="seconds"),
+            "binary_sha256": sweep.file_sha256(args.binary),
+            "ns3": sweep.ns3_version(args.ns3_dir),
+            "host": platform.node(),
+            "machine": platform.machine(),
+            "python": platform.python_version(),
+            "simTime": args.simTime,
+            "payloadSize": args.payloadSize,
+            "lambda": args.lambda_sta,
+            "run": args.run,
+            "repeat": args.repeat,
+            "extra_args": args.extra_args,
+        },
+        "scenarios": {},
+    }
+
+    groups = ["queue", "failures", "tb", "airtime", "ap", "latency", "traffic", "control", "ns3"]
+    print("{:<18} {:>8} {:>11} {:>11} {:>9}  ".format("scenario", "wall[s]", "events", "events/s", "RSS[KB]")
+          + " ".join(f"{g:>8}" for g in groups))
+    for nl, mh, mu in REFERENCE:
+        name = scenario_name(nl, mh, mu)
+        try:
+            r = bench_scenario(args, nl, mh, mu)
+        except RuntimeError as e:
+            print(f"{name}: {e}", file=sys.stderr)
+            return 1
+        result["scenarios"][name] = r
+        print(f"{name:<18} {r['run_wall_s']:>8.3f} {r['events']:>11} {r['events_per_s']:>11.0f} "
+              f"{r['max_rss_kb']:>9}  " + " ".join(f"{100 * r['share'].get(g, 0.0):>7.1f}%" for g in groups),
+              flush=True)
+        if r.get("perf_percent"):
+            print(f"{'':<18} perf: " + "  ".join(f"{k}={v:.1f}%" for k, v in r["perf_percent"].items()))
+
+    if args.save:
+        tmp = args.save + ".tmp"
+        with open(tmp, "w", encoding="utf-8") as f:
+            json.dump(result, f, indent=1, sort_keys=True)
+        os.replace(tmp, args.save)
+        print(f"Wrote {args.save}", file=sys.stderr)
+
+    if args.baseline:
+        with open(args.baseline, "r", encoding="utf-8") as f:
+            baseline = json.load(f)
+        print()
+        if compare(baseline, result, args.tolerance):
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
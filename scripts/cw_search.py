@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+"""
+Model-guided search for the best fairness-feasible AP CW pair.
+
+For every (nLegacy, mHe, mu), find the (cwmin, cwmax) that maximizes network
+throughput subject to Jain_group >= eta (as compute_best_feasible in
+plot_results.py does), over all power-of-two-minus-one pairs
+cwmin <= cwmax <= 1023 (55 pairs) instead of the 8 CW_PAIRS of
+run_fairness_sweep.sh, while simulating only a fraction of them.
+
+Search, per mu (all mus advance together on one worker pool):
+
+  1. Prior: the analytical model's best pair (model_best_cwmin/cwmax in
+     best_cw_fairness_eta0p95_obs_vs_model.csv) and its nearest pairs in
+     log2(CW+1) space are simulated first.
+  2. Surrogate: a quadratic least-squares fit in (log2 cwmin, log2 cwmax) of
+     throughput and of Jain_group over the pairs simulated so far predicts the
+     remaining ones.
+
+     With --model-bin (the ul-ofdma-model tool), the model is evaluated on
+     every candidate instead: its best feasible pair is the prior, and the
+     surrogate becomes model + fitted correction (a constant offset until
+     six pairs are simulated).
+  3. Every round simulates the unevaluated neighbours of the incumbent (best
+     feasible pair so far), then the pairs with the highest predicted feasible
+     throughput.
+  4. A mu is done when all neighbours of the incumbent are simulated and no
+     remaining pair is predicted to beat it by more than --tol, or after
+     --max-candidates pairs.
+
+Runs are executed and cached exactly like sweep.py (same directory layout,
+so both tools share finished runs), and the per-mu files plot_results.py
+reads are assembled from the simulated pairs.
+"""
+import argparse
+import csv
+import io
+import math
+import os
+import subprocess
+import sys
+from typing import Dict, List, Optional, Sequence, Tuple
+
+import sweep
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_MODEL_CSV = os.path.join(SCRIPT_DIR, "..", "results", "processed",
+                                 "best_cw_fairness_eta0p95_obs_vs_model.csv")
+DEFAULT_CW_VALUES = [(1 << k) - 1 for k in range(1, 11)]  # 1, 3, ..., 1023
+
+Pair = Tuple[int, int]
+
+
+# -----------------------------
+# Candidate space
+# -----------------------------
+
+def candidate_pairs(values: Sequence[int]) -> List[Pair]:
+    return [(a, b) for a in values for b in values if a <= b]
+
+
+def coords(p: Pair) -> Tuple[float, float]:
+    return (math.log2(p[0] + 1.0), math.log2(p[1] + 1.0))
+
+
+def dist2(p: Pair, q: Pair) -> float:
+    (x0, y0), (x1, y1) = coords(p), coords(q)
+    return (x0 - x1) ** 2 + (y0 - y1) ** 2
+
+
+def neighbours(p: Pair, values: Sequence[int]) -> List[Pair]:
+    """Pairs one step away on the CW value grid (8-neighbourhood)."""
+    i, j = values.index(p[0]), values.index(p[1])
+    out = []
+    for di in (-1, 0, 1):
+        for dj in (-1, 0, 1):
+            a, b = i + di, j + dj
+            if (di or dj) and 0 <= a < len(values) and 0 <= b < len(values) and a <= b:
+                out.append((values[a], values[b]))
+    return out
+
+
+def load_prior(model_csv: str, n_legacy: int, m_he: int) -> Dict[float, Pair]:
+    """model best (cwmin, cwmax) per mu for this population."""
+    prior = {}
+    if not model_csv or not os.path.exists(model_csv):
+        return prior
+    with open(model_csv, "r", encoding="utf-8") as f:
+        for row in csv.DictReader(f):
+            if int(row["nL"]) == n_legacy and int(row["nH"]) == m_he:
+                prior[float(row["mu"])] = (int(float(row["model_best_cwmin"])),
+                                           int(float(row["model_best_cwmax"])))
+    return prior
+
+
+def screen_model(model_bin: str, args: argparse.Namespace, values: Sequence[int]) -> Dict[float, Dict[Pair, tuple]]:
+    """ul-ofdma-model --screen predictions: mu -> pair -> (thr, jain)."""
+    cmd = [model_bin, "--screen", f"--nL={args.nLegacy}", f"--nH={args.mHe}",
+           "--mu=" + ",".join(args.mu), "--cw=" + ",".join(str(v) for v in values),
+           f"--payloadSize={args.payloadSize}"]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, check=True, text=True)
+    out: Dict[float, Dict[Pair, tuple]] = {}
+    for row in csv.DictReader(io.StringIO(proc.stdout)):
+        pair = (int(float(row["apCwMin"])), int(float(row["apCwMax"])))
+        out.setdefault(float(row["mu"]), {})[pair] = (float(row["thr_total_mbps"]), float(row["jain_group"]))
+    return out
+
+
+def model_best(pred: Dict[Pair, tuple], eta: float) -> Optional[Pair]:
+    feas = [p for p, (t, j) in pred.items() if j >= eta]
+    return max(feas, key=lambda p: pred[p][0]) if feas else None
+
+
+def snap(p: Pair, cands: Sequence[Pair]) -> Pair:
+    """Closest candidate to a (possibly off-grid) pair."""
+    return min(cands, key=lambda q: dist2(p, q))
+
+
+# -----------------------------
+# Surrogate (stdlib only, like sweep.py: a 6x6 ridge solve)
+# -----------------------------
+
+def quad_features(p: Pair) -> List[float]:
+    x, y = coords(p)
+    return [1.0, x, y, x * x, y * y, x * y]
+
+
+def solve(a: List[List[float]], b: List[float]) -> List[float]:
+    """Gaussian elimination with partial pivoting (a is small and SPD here)."""
+    n = len(b)
+    m = [row[:] + [b[i]] for i, row in enumerate(a)]
+    for c in range(n):
+        piv = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[piv] = m[piv], m[c]
+        for r in range(c + 1, n):
+            f = m[r][c] / m[c][c]
+            for k in range(c, n + 1):
+                m[r][k] -= f * m[c][k]
+    x = [0.0] * n
+    for r in range(n - 1, -1, -1):
+        x[r] = (m[r][n] - sum(m[r][k] * x[k] for k in range(r + 1, n))) / m[r][r]
+    return x
+
+
+def fit_predict(known: Dict[Pair, Tuple[float, float]], query: Sequence[Pair],
+                ridge: float = 1e-3) -> Optional[List[Tuple[float, float]]]:
+    """Predicted (thr, jain) for query pairs, or None with too few points."""
+    if len(known) < 6 or not query:
+        return None
+    feats = [quad_features(p) for p in known]
+    n = len(feats[0])
+    ata = [[sum(f[i] * f[j] for f in feats) + (ridge if i == j else 0.0) for j in range(n)] for i in range(n)]
+    coefs = []
+    for k in range(2):
+        aty = [sum(f[i] * v[k] for f, v in zip(feats, known.values())) for i in range(n)]
+        coefs.append(solve(ata, aty))
+    out = []
+    for p in query:
+        f = quad_features(p)
+        out.append(tuple(sum(c * x for c, x in zip(coef, f)) for coef in coefs))
+    return out
+
+
+# -----------------------------
+# Per-mu search state
+# -----------------------------
+
+class MuSearch:
+    def __init__(self, mu: str, prior: Pair, cands: List[Pair], values: List[int], args: argparse.Namespace,
+                 model: Optional[Dict[Pair, tuple]] = None):
+        self.mu = mu
+        self.prior = prior
+        self.model = model
+        self.cands = cands
+        self.values = values
+        self.args = args
+        self.known: Dict[Pair, Tuple[float, float]] = {}  # pair -> (thr, jain_group)
+        self.done = False
+
+    def incumbent(self) -> Optional[Pair]:
+        feas = [p for p, (t, j) in self.known.items() if j >= self.args.eta]
+        return max(feas, key=lambda p: self.known[p][0]) if feas else None
+
+    def by_prior(self, ps: Sequence[Pair]) -> List[Pair]:
+        return sorted(ps, key=lambda q: (dist2(self.prior, q), q))
+
+    def predict(self, rest: Sequence[Pair]) -> Optional[List[Tuple[float, float]]]:
+        if self.model is None:
+            return fit_predict(self.known, rest)
+        # Model + correction fitted to the residuals of the simulated pairs
+        resid = {p: (t - self.model[p][0], j - self.model[p][1]) for p, (t, j) in self.known.items()}
+        corr = fit_predict(resid, rest)
+        if corr is None:
+            mean = tuple(sum(r[k] for r in resid.values()) / len(resid) for k in range(2))
+            corr = [mean] * len(rest)
+        return [(self.model[p][0] + c[0], self.model[p][1] + c[1]) for p, c in zip(rest, corr)]
+
+    def propose(self) -> List[Pair]:
+        """Next pairs to simulate; marks the search done when there are none."""
+        args = self.args
+        rest = [p for p in self.cands if p not in self.known]
+        if not self.known:
+            return self.by_prior(rest)[:args.initial]
+        if not rest or len(self.known) >= args.max_candidates:
+            self.done = True
+            return []
+
+        budget = min(args.per_round, args.max_candidates - len(self.known))
+        inc = self.incumbent()
+        picks: List[Pair] = []
+        if inc is not None:
+            picks = [q for q in self.by_prior(neighbours(inc, self.values)) if q not in self.known][:budget]
+
+        pred = self.predict(rest)
+        if pred is None:
+            ranked = self.by_prior(rest)
+        else:
+            margin = args.jain_margin
+            scored = []
+            for p, (t, j) in zip(rest, pred):
+                if inc is None:
+                    # No feasible pair yet: head for the predicted fairest region.
+                    scored.append((-j, p))
+                elif j >= args.eta - margin:
+                    scored.append((-t, p))
+            ranked = [p for _, p in sorted(scored)]
+            if inc is not None and not picks:
+                best_thr = self.known[inc][0]
+                if not ranked or -sorted(scored)[0][0] <= best_thr * (1.0 + args.tol):
+                    self.done = True
+                    return []
+
+        for p in ranked:
+            if len(picks) >= budget:
+                break
+            if p not in picks:
+                picks.append(p)
+        if not picks:
+            self.done = True
+        return picks
+
+
+# -----------------------------
+# Main
+# -----------------------------
+
+def main():
+    ap = argparse.ArgumentParser(description="Model-guided search of the best fairness-feasible AP CW pair per mu.")
+    sweep.add_common_arguments(ap)
+    ap.add_argument("--mu", nargs="+", default=sweep.DEFAULT_MU_INTERVALS, help="muAccessReqInterval values")
+    ap.add_argument("--runs", type=int, default=30, help="Simulate RngRun 0..RUNS (inclusive) per candidate pair")
+    ap.add_argument("--conf", type=float, default=0.95, help="Confidence level passed to the aggregator")
+    ap.add_argument("--eta", type=float, default=0.95, help="Fairness threshold (Jain_group >= eta)")
+    ap.add_argument("--model-csv", default=DEFAULT_MODEL_CSV,
+                    help="CSV with model_best_cwmin/model_best_cwmax per (nL, nH, mu) used as prior")
+    ap.add_argument("--cw-values", type=int, nargs="+", default=DEFAULT_CW_VALUES,
+                    help="CW values forming the candidate pairs (cwmin <= cwmax)")
+    ap.add_argument("--model-bin", default=None,
+                    help="ul-ofdma-model executable; its predictions replace the CSV prior and anchor the surrogate")
+    ap.add_argument("--initial", type=int, default=6, help="Pairs nearest the prior simulated first")
+    ap.add_argument("--per-round", type=int, default=2, help="Pairs simulated per mu and round")
+    ap.add_argument("--max-candidates", type=int, default=20, help="Upper bound on pairs simulated per mu")
+    ap.add_argument("--tol", type=float, default=0.005,
+                    help="Stop when no pair is predicted to beat the incumbent by more than this fraction")
+    ap.add_argument("--jain-margin", type=float, default=0.02,
+                    help="Pairs predicted within this margin below eta are still considered feasible")
+    ap.add_argument("--no-assemble", action="store_true", help="Do not write per-mu files")
+    ap.add_argument("--extra-args", nargs=argparse.REMAINDER, default=[],
+                    help="Further fairness11ax arguments, passed verbatim (must come last)")
+    args = ap.parse_args()
+    sweep.resolve_tools(args)
+    if not args.aggregator:
+        ap.error("cw_search.py needs the fairness-aggregate tool (--aggregator)")
+
+    values = sorted(set(args.cw_values))
+    cands = candidate_pairs(values)
+    prior = load_prior(args.model_csv, args.nLegacy, args.mHe)
+    runs = list(range(0, args.runs + 1))
+
+    screened = screen_model(args.model_bin, args, values) if args.model_bin else {}
+
+    searches = []
+    for mu in args.mu:
+        p = next((v for k, v in prior.items() if abs(k - float(mu)) < 1e-12), (15, 1023))
+        pred = next((v for k, v in screened.items() if abs(k - float(mu)) < 1e-12), None)
+        if pred is not None:
+            p = model_best(pred, args.eta) or p
+        searches.append(MuSearch(mu, snap(p, cands), cands, values, args, pred))
+
+    failures = 0
+    while True:
+        proposals = {s.mu: s.propose() for s in searches if not s.done}
+        jobs = [sweep.Job(mu, a, b, r) for mu, ps in proposals.items() for (a, b) in ps for r in runs]
+        if not jobs:
+            break
+        failures += sweep.run_jobs(args, jobs)
+        if failures:
+            break
+        for s in searches:
+            for (a, b) in proposals.get(s.mu, []):
+                row = sweep.point_ci(args, s.mu, a, b, len(runs))
+                s.known[(a, b)] = (float(row["thr_total_mbps"]), float(row["jain_group"]))
+                if args.verbose:
+                    print(f"mu={s.mu} cw={a}:{b} thr={s.known[(a, b)][0]:.3f} jain={s.known[(a, b)][1]:.4f}",
+                          file=sys.stderr)
+
+    os.makedirs(args.outdir, exist_ok=True)
+    tag = f"nL{args.nLegacy}_mH{args.mHe}"
+    with open(os.path.join(args.outdir, f"cw_search_{tag}_evals.csv"), "w", encoding="utf-8", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["mu", "cwmin", "cwmax", "thr_total_mbps", "jain_group"])
+        for s in searches:
+            for (a, b), (t, j) in s.known.items():
+                w.writerow([s.mu, a, b, f"{t:.6f}", f"{j:.6f}"])
+
+    summary = os.path.join(args.outdir, f"cw_search_{tag}.csv")
+    with open(summary, "w", encoding="utf-8", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["nLegacy", "nHe", "mu", "best_thr_obs", "best_cwmin_obs", "best_cwmax_obs", "best_jain_obs",
+                    "prior_cwmin", "prior_cwmax", "pairs_simulated", "pairs_total"])
+        for s in searches:
+            inc = s.incumbent()
+            best = [f"{s.known[inc][0]:.6f}", inc[0], inc[1], f"{s.known[inc][1]:.6f}"] if inc else ["", "", "", ""]
+            w.writerow([args.nLegacy, args.mHe, s.mu] + best + [s.prior[0], s.prior[1], len(s.known), len(cands)])
+    print(f"Wrote {summary}", file=sys.stderr)
+
+    if not args.no_assemble:
+        for s in searches:
+            if s.known:
+                sweep.assemble(args, [s.mu], sorted(s.known), runs)
+
+    if failures:
+        print(f"{failures} job(s) failed; rerun to retry them (finished runs are kept).", file=sys.stderr)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -13,19 +13,19 @@ MU_INTERVAL=0.05
 N_RUNS=30
 # --------------------------------
 
-for i in $(seq 0 $N_RUNS); do
-  ./ns3 run "fairness11ax \
-    --nLegacy=$N_LEGACY \
-    --mHe=$M_HE \
-    --simTime=$SIM_TIME \
-    --payloadSize=$PAYLOAD \
-    --lambdaLegacy=$LAMBDA_LEGACY \
-    --lambdaHe=$LAMBDA_HE \
-    --apCwMin=$AP_CWMIN \
-    --apCwMax=$AP_CWMAX \
-    --muAccessReqInterval=$MU_INTERVAL" \
-    --command-template="%s --RngRun=$i"
-done | awk -f ./process.awk
+# All RngRuns are simulated inside one fairness11ax process.
+./ns3 run "fairness11ax \
+  --nLegacy=$N_LEGACY \
+  --mHe=$M_HE \
+  --simTime=$SIM_TIME \
+  --payloadSize=$PAYLOAD \
+  --lambdaLegacy=$LAMBDA_LEGACY \
+  --lambdaHe=$LAMBDA_HE \
+  --apCwMin=$AP_CWMIN \
+  --apCwMax=$AP_CWMAX \
+  --muAccessReqInterval=$MU_INTERVAL \
+  --runFirst=0 \
+  --runLast=$N_RUNS" | awk -f ./process.awk
 
 # ---- print experiment configuration (footer) ----
 echo ""
@@ -1,6 +1,8 @@
 #!/usr/bin/env python3
 import argparse
 import glob
+import hashlib
+import json
 import os
 import re
 from dataclasses import dataclass
@@ -126,6 +128,121 @@ def load_all_results(input_dir: str, pattern: str = "fairness_nLegacy*_mHe*_mu*.
     return df
 
 
+# -----------------------------
+# Record files (fairness11ax --outFormat=csv|binary, ns3/fairness-record.h)
+# -----------------------------
+
+RECORD_MAGIC = b"FAIRREC\0"
+
+# StaRecord fields in order (version 6). Older files hold a prefix of them.
+RECORD_FIELDS = [
+    ("run", "<u8"), ("mu", "<f8"), ("simTime", "<f8"), ("lambda", "<f8"), ("throughputMbps", "<f8"),
+    ("avgMacQueue", "<f8"), ("rxBytes", "<u8"), ("collisionsLike", "<u8"), ("finalFailures", "<u8"),
+    ("phyTxDrops", "<u8"), ("heSuTxMpdu", "<u8"), ("heTbTxMpdu", "<u8"), ("heSuTxBytes", "<u8"),
+    ("heTbTxBytes", "<u8"), ("cwMin", "<u4"), ("cwMax", "<u4"), ("nLegacy", "<u4"), ("mHe", "<u4"),
+    ("sta", "<u4"), ("type", "<u4"),
+    ("rxPackets", "<u8"), ("delayP50Us", "<f8"), ("delayP95Us", "<f8"), ("delayP99Us", "<f8"),
+    ("delayMaxUs", "<f8"), ("jitterP50Us", "<f8"), ("jitterP99Us", "<f8"),
+    ("bss", "<u4"), ("channel", "<u4"),
+    ("intervalEnd", "<f8"), ("kind", "<u4"), ("interval", "<u4"),
+    ("airtimeSuMs", "<f8"), ("airtimeTbMs", "<f8"), ("airtimeLegacyMs", "<f8"), ("mstaBaEntries", "<u8"),
+    ("mstaBaAllAck", "<u8"), ("seed", "<u8"), ("configHash", "<u8"),
+]
+
+# Columns the CW-level reduction needs (bss and kind are optional: v3 / v4)
+RECORD_COLUMNS = ["mu", "throughputMbps", "cwMin", "cwMax", "nLegacy", "mHe", "sta", "type", "bss", "kind",
+                  "configHash"]
+
+POINT_KEYS = ["nLegacy", "mHe", "mu", "cwMin", "cwMax"]
+
+
+def record_dtype(record_size: int) -> np.dtype:
+    """Structured dtype of the fields that fit in record_size bytes, with record_size as the stride."""
+    names, formats, offsets = [], [], []
+    off = 0
+    for name, fmt in RECORD_FIELDS:
+        size = np.dtype(fmt).itemsize
+        if off + size > record_size:
+            break
+        names.append(name)
+        formats.append(fmt)
+        offsets.append(off)
+        off += size
+    return np.dtype({"names": names, "formats": formats, "offsets": offsets, "itemsize": record_size})
+
+
+def read_record_columns(path: str) -> Dict[str, np.ndarray]:
+    """
+    The RECORD_COLUMNS of one record file. Binary files are memory-mapped and
+    only the needed columns are copied out; CSV files are read column-wise.
+    """
+    if os.path.getsize(path) == 0:
+        return {}
+    with open(path, "rb") as f:
+        head = f.read(16)
+    if head[:8] == RECORD_MAGIC:
+        _, record_size = np.frombuffer(head[8:16], dtype="<u4")
+        n = (os.path.getsize(path) - 16) // int(record_size)
+        if n <= 0:
+            return {}
+        rec = np.memmap(path, dtype=record_dtype(int(record_size)), mode="r", offset=16, shape=(n,))
+        return {c: np.array(rec[c]) for c in RECORD_COLUMNS if c in rec.dtype.names}
+    header = pd.read_csv(path, nrows=0).columns
+    df = pd.read_csv(path, usecols=[c for c in RECORD_COLUMNS if c in header])
+    return {c: df[c].to_numpy() for c in df.columns}
+
+
+def load_records(paths: List[str]) -> pd.DataFrame:
+    """
+    CW-level table (same columns as load_all_results) from record files, with
+    the metrics of process.awk: per-STA mean throughput over the runs of a
+    point, network throughput as their sum, group averages over the STAs of
+    each group and Jain_group of the two averages. Interval records are
+    ignored; multi-BSS cells are merged (STAs keyed by (bss, sta)). A point
+    whose records carry more than one configHash (runs of another simTime,
+    load, ... mixed in) is refused rather than averaged.
+    """
+    parts = []
+    for path in paths:
+        cols = read_record_columns(path)
+        if cols:
+            parts.append(pd.DataFrame(cols))
+    if not parts:
+        raise RuntimeError("No records in: " + ", ".join(paths))
+    rec = pd.concat(parts, ignore_index=True)
+    if "bss" not in rec:
+        rec["bss"] = 0
+    if "kind" in rec:
+        rec = rec[rec["kind"] == 0]
+    if "configHash" not in rec:
+        rec["configHash"] = 0
+
+    configs = rec.groupby(POINT_KEYS)["configHash"].nunique()
+    mixed = configs[configs > 1]
+    if not mixed.empty:
+        key = dict(zip(POINT_KEYS, mixed.index[0]))
+        hashes = sorted(rec.loc[(rec[POINT_KEYS] == pd.Series(key)).all(axis=1), "configHash"].unique())
+        raise ValueError(f"Records of point {key} come from {len(hashes)} configurations (configHash "
+                         + ", ".join(f"{int(h):016x}" for h in hashes)
+                         + "); pass the record files of one configuration")
+
+    sta = rec.groupby(POINT_KEYS + ["bss", "sta", "type"], sort=False)["throughputMbps"].mean().reset_index()
+    net = sta.groupby(POINT_KEYS)["throughputMbps"].sum().rename("thr_total_mbps")
+    grp = sta.pivot_table(index=POINT_KEYS, columns="type", values="throughputMbps", aggfunc="mean")
+    he = grp[1] if 1 in grp else pd.Series(0.0, index=grp.index)
+    legacy = grp[0] if 0 in grp else pd.Series(0.0, index=grp.index)
+    he, legacy = he.fillna(0.0), legacy.fillna(0.0)
+    denom = 2.0 * (he * he + legacy * legacy)
+    jain = ((he + legacy) ** 2 / denom.where(denom > 0)).fillna(0.0)
+
+    out = pd.concat([net, he.rename("thr_he_avg_mbps"), legacy.rename("thr_legacy_avg_mbps"),
+                     jain.rename("jain_group")], axis=1).reset_index()
+    out = out.rename(columns={"mHe": "nHe", "cwMin": "apCwMin", "cwMax": "apCwMax"})
+    out["src_file"] = "records"
+    return out[["nLegacy", "nHe", "mu", "apCwMin", "apCwMax", "thr_total_mbps", "thr_he_avg_mbps",
+                "thr_legacy_avg_mbps", "jain_group", "src_file"]]
+
+
 # -----------------------------
 # Plotting
 # -----------------------------
@@ -138,15 +255,19 @@ def scenario_tag(nL: int, nH: int) -> str:
     return f"nL{nL}_nH{nH}"
 
 
-def plot_scatter_thr_vs_fairness(df: pd.DataFrame, outdir: str, by_mu: bool = False) -> None:
+def plot_scatter_thr_vs_fairness(df: pd.DataFrame, outdir: str, by_mu: bool = False,
+                                 only: Optional[set] = None) -> None:
     """
     Scatter plot of total throughput vs Jain fairness for each scenario.
     If by_mu=True, generate one figure per mu; otherwise one combined figure per scenario.
+    only: restrict to these (nLegacy, nHe) scenarios.
     """
     ensure_dir(outdir)
     scenarios = sorted(df[["nLegacy", "nHe"]].drop_duplicates().itertuples(index=False, name=None))
 
     for nL, nH in scenarios:
+        if only is not None and (nL, nH) not in only:
+            continue
         sdf = df[(df["nLegacy"] == nL) & (df["nHe"] == nH)].copy()
         sdf.sort_values(["mu", "apCwMin", "apCwMax"], inplace=True)
 
@@ -186,28 +307,20 @@ def compute_best_feasible(df: pd.DataFrame, eta: float) -> pd.DataFrame:
     Returns rows: nLegacy,nHe,mu,best_thr_obs,best_cwmin,best_cwmax,best_jain
     Missing feasibility -> NaN best_thr_obs.
     """
-    out_rows = []
-    for (nL, nH, mu), g in df.groupby(["nLegacy", "nHe", "mu"]):
-        feas = g[g["jain_group"] >= eta].copy()
-        if feas.empty:
-            out_rows.append({
-                "nLegacy": nL, "nHe": nH, "mu": mu,
-                "best_thr_obs": np.nan,
-                "best_cwmin_obs": np.nan,
-                "best_cwmax_obs": np.nan,
-                "best_jain_obs": np.nan
-            })
-            continue
-        best = feas.loc[feas["thr_total_mbps"].idxmax()]
-        out_rows.append({
-            "nLegacy": nL, "nHe": nH, "mu": mu,
-            "best_thr_obs": float(best["thr_total_mbps"]),
-            "best_cwmin_obs": int(best["apCwMin"]),
-            "best_cwmax_obs": int(best["apCwMax"]),
-            "best_jain_obs": float(best["jain_group"])
-        })
-    out = pd.DataFrame(out_rows).sort_values(["nLegacy", "nHe", "mu"])
-    return out
+    keys = ["nLegacy", "nHe", "mu"]
+    df = df.reset_index(drop=True)
+    # One grouped idxmax over the feasible rows (first row wins ties), then a
+    # left join onto every (nLegacy, nHe, mu) so infeasible groups get NaN.
+    feas = df[df["jain_group"] >= eta]
+    idx = feas.groupby(keys, sort=False)["thr_total_mbps"].idxmax()
+    best = df.loc[idx.to_numpy(), keys + ["thr_total_mbps", "apCwMin", "apCwMax", "jain_group"]].rename(columns={
+        "thr_total_mbps": "best_thr_obs",
+        "apCwMin": "best_cwmin_obs",
+        "apCwMax": "best_cwmax_obs",
+        "jain_group": "best_jain_obs",
+    })
+    out = df[keys].drop_duplicates().merge(best, on=keys, how="left")
+    return out.sort_values(keys).reset_index(drop=True)
 
 
 def load_model_best(model_csv: str) -> pd.DataFrame:
@@ -224,11 +337,13 @@ def load_model_best(model_csv: str) -> pd.DataFrame:
 
 
 def plot_best_thr_vs_mu(best_obs: pd.DataFrame, outdir: str, eta: float,
-                        model_best: Optional[pd.DataFrame] = None) -> None:
+                        model_best: Optional[pd.DataFrame] = None, only: Optional[set] = None) -> None:
     ensure_dir(outdir)
     scenarios = sorted(best_obs[["nLegacy", "nHe"]].drop_duplicates().itertuples(index=False, name=None))
 
     for nL, nH in scenarios:
+        if only is not None and (nL, nH) not in only:
+            continue
         sdf = best_obs[(best_obs["nLegacy"] == nL) & (best_obs["nHe"] == nH)].copy()
         sdf.sort_values("mu", inplace=True)
 
@@ -269,9 +384,55 @@ def plot_best_thr_vs_mu(best_obs: pd.DataFrame, outdir: str, eta: float,
             plt.close()
 
 
+# -----------------------------
+# Incremental re-plotting
+# -----------------------------
+
+STATE_FILE = ".plot_state.json"
+
+
+def scenario_digests(df: pd.DataFrame, settings: Dict) -> Dict[str, str]:
+    """Digest of every scenario's CW-level rows and the plot settings, keyed by scenario tag."""
+    base = json.dumps(settings, sort_keys=True)
+    cols = ["mu", "apCwMin", "apCwMax", "thr_total_mbps", "thr_he_avg_mbps", "thr_legacy_avg_mbps", "jain_group"]
+    out = {}
+    for (nL, nH), g in df.groupby(["nLegacy", "nHe"]):
+        rows = g.sort_values(["mu", "apCwMin", "apCwMax"])[cols].to_csv(index=False)
+        out[scenario_tag(nL, nH)] = hashlib.sha256((base + rows).encode()).hexdigest()
+    return out
+
+
+def changed_scenarios(df: pd.DataFrame, outdir: str, settings: Dict, force: bool) -> Tuple[set, Dict[str, str]]:
+    """(nLegacy, nHe) scenarios whose results or settings differ from the last run in outdir."""
+    digests = scenario_digests(df, settings)
+    old: Dict[str, str] = {}
+    path = os.path.join(outdir, STATE_FILE)
+    if not force and os.path.exists(path):
+        with open(path, encoding="utf-8") as f:
+            old = json.load(f)
+    todo = set()
+    for nL, nH in df[["nLegacy", "nHe"]].drop_duplicates().itertuples(index=False, name=None):
+        tag = scenario_tag(nL, nH)
+        figure = os.path.join(outdir, f"best_thr_vs_mu_{tag}.png")
+        if old.get(tag) != digests[tag] or not os.path.exists(figure):
+            todo.add((nL, nH))
+    return todo, digests
+
+
+def save_state(outdir: str, digests: Dict[str, str]) -> None:
+    path = os.path.join(outdir, STATE_FILE)
+    with open(path + ".tmp", "w", encoding="utf-8") as f:
+        json.dump(digests, f, indent=1, sort_keys=True)
+    os.replace(path + ".tmp", path)
+
+
 def main():
     ap = argparse.ArgumentParser(description="Plot ns-3 fairness sweep results from fairness_nLegacy*_mHe*_mu*.txt files.")
-    ap.add_argument("--input", required=True, help="Directory containing fairness_nLegacy*_mHe*_mu*.txt files")
+    ap.add_argument("--input", default=None, help="Directory containing fairness_nLegacy*_mHe*_mu*.txt files")
+    ap.add_argument("--records", nargs="+", default=[],
+                    help="Record files (--outFormat=binary|csv) read directly; binary files are memory-mapped")
+    ap.add_argument("--force", action="store_true",
+                    help="Re-plot every scenario (default: only those whose results changed since the last run)")
     ap.add_argument("--outdir", default="figs", help="Output directory for figures")
     ap.add_argument("--eta", type=float, default=0.95, help="Fairness threshold for best-feasible throughput")
     ap.add_argument("--scatter_by_mu", action="store_true", help="Generate scatter plot per mu (more figures)")
@@ -279,8 +440,15 @@ def main():
                     help="Optional CSV to overlay model results. Columns: nLegacy,nHe,mu,best_thr_model")
     ap.add_argument("--export_csv", action="store_true", help="Export parsed CW-level table and best-feasible table as CSV")
     args = ap.parse_args()
+    if not args.input and not args.records:
+        ap.error("one of --input or --records is required")
 
-    df = load_all_results(args.input)
+    tables = []
+    if args.input:
+        tables.append(load_all_results(args.input))
+    if args.records:
+        tables.append(load_records(args.records))
+    df = pd.concat(tables, ignore_index=True)
 
     ensure_dir(args.outdir)
 
@@ -288,18 +456,24 @@ def main():
     if args.export_csv:
         df.to_csv(os.path.join(args.outdir, "parsed_cw_level.csv"), index=False)
 
+    model_best = load_model_best(args.model_best_csv) if args.model_best_csv else None
+    settings = {"eta": args.eta, "scatter_by_mu": args.scatter_by_mu,
+                "model": model_best.to_csv(index=False) if model_best is not None else None}
+    todo, digests = changed_scenarios(df, args.outdir, settings, args.force)
+
     # Scatter: throughput vs fairness
-    plot_scatter_thr_vs_fairness(df, args.outdir, by_mu=args.scatter_by_mu)
+    plot_scatter_thr_vs_fairness(df, args.outdir, by_mu=args.scatter_by_mu, only=todo)
 
     # Best-feasible: throughput vs mu
     best_obs = compute_best_feasible(df, eta=args.eta)
     if args.export_csv:
         best_obs.to_csv(os.path.join(args.outdir, f"best_feasible_eta{args.eta:g}.csv"), index=False)
 
-    model_best = load_model_best(args.model_best_csv) if args.model_best_csv else None
-    plot_best_thr_vs_mu(best_obs, args.outdir, eta=args.eta, model_best=model_best)
+    plot_best_thr_vs_mu(best_obs, args.outdir, eta=args.eta, model_best=model_best, only=todo)
+    save_state(args.outdir, digests)
 
-    print(f"Done. Figures saved to: {args.outdir}")
+    n_all = len(digests)
+    print(f"Done. Re-plotted {len(todo)}/{n_all} scenarios; figures saved to: {args.outdir}")
 
 
 if __name__ == "__main__":
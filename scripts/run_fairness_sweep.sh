@@ -33,19 +33,19 @@ run_one_pair() {
   local cwmin="$2"
   local cwmax="$3"
 
-  for i in $(seq 0 "$N_RUNS"); do
-    ./ns3 run "fairness11ax \
-      --nLegacy=$N_LEGACY \
-      --mHe=$M_HE \
-      --simTime=$SIM_TIME \
-      --payloadSize=$PAYLOAD \
-      --lambdaLegacy=$LAMBDA_LEGACY \
-      --lambdaHe=$LAMBDA_HE \
-      --apCwMin=$cwmin \
-      --apCwMax=$cwmax \
-      --muAccessReqInterval=$mu_interval" \
-      --command-template="%s --RngRun=$i"
-  done | awk -f ./process.awk
+  # One process per CW pair: RngRuns 0..N_RUNS are looped in-process.
+  ./ns3 run "fairness11ax \
+    --nLegacy=$N_LEGACY \
+    --mHe=$M_HE \
+    --simTime=$SIM_TIME \
+    --payloadSize=$PAYLOAD \
+    --lambdaLegacy=$LAMBDA_LEGACY \
+    --lambdaHe=$LAMBDA_HE \
+    --apCwMin=$cwmin \
+    --apCwMax=$cwmax \
+    --muAccessReqInterval=$mu_interval \
+    --runFirst=0 \
+    --runLast=$N_RUNS" | awk -f ./process.awk
 }
 
 for mu in "${MU_INTERVALS[@]}"; do
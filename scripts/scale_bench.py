@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Scaling benchmark of fairness11ax: setup time, event rate and memory as the
+number of stations grows.
+
+For every total STA count N in --sizes, one replication is run with
+N * --he-fraction HE STAs and the rest legacy, STAs spread over a disc
+(--placement=disc) and --reportPerf, and the "Perf:" line of each run is
+tabulated:
+
+    nTotal,nLegacy,mHe,setup_wall_s,run_wall_s,events,events_per_s,max_rss_kb
+
+Example:
+
+    python3 scripts/scale_bench.py --ns3-dir ~/ns-3 --sizes 10 50 100 200 500 --simTime 0.5
+"""
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import time
+
+import sweep
+
+PERF_RE = re.compile(r"Perf: nTotal=(\d+) setupWall=([0-9.eE+-]+)s runWall=([0-9.eE+-]+)s "
+                     r"events=(\d+) events/s=([0-9.eE+-]+) maxRss=(\d+) KB")
+
+COLUMNS = ["nTotal", "nLegacy", "mHe", "setup_wall_s", "run_wall_s", "events", "events_per_s", "max_rss_kb"]
+
+
+def run_size(args: argparse.Namespace, n_total: int) -> dict:
+    m_he = int(round(n_total * args.he_fraction))
+    n_legacy = n_total - m_he
+    cmd = [
+        args.binary,
+        f"--nLegacy={n_legacy}",
+        f"--mHe={m_he}",
+        f"--simTime={args.simTime}",
+        f"--payloadSize={args.payloadSize}",
+        f"--lambdaLegacy={args.lambda_sta}",
+        f"--lambdaHe={args.lambda_sta}",
+        f"--placement={args.placement}",
+        f"--placementRadius={args.radius}",
+        "--reportPerf=true",
+        f"--RngRun={args.run}",
+    ] + args.extra_args
+    t0 = time.monotonic()
+    proc = subprocess.run(cmd, cwd=args.ns3_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+    wall = time.monotonic() - t0
+    if proc.returncode != 0:
+        raise RuntimeError(f"N={n_total}: exit code {proc.returncode}: {proc.stderr.strip()[-500:]}")
+    m = PERF_RE.search(proc.stdout)
+    if not m:
+        raise RuntimeError(f"N={n_total}: no Perf line in output (binary without --reportPerf?)")
+    if args.verbose:
+        print(f"N={n_total}: process wall {wall:.2f}s", file=sys.stderr)
+    return {
+        "nTotal": int(m.group(1)),
+        "nLegacy": n_legacy,
+        "mHe": m_he,
+        "setup_wall_s": float(m.group(2)),
+        "run_wall_s": float(m.group(3)),
+        "events": int(m.group(4)),
+        "events_per_s": float(m.group(5)),
+        "max_rss_kb": int(m.group(6)),
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Measure fairness11ax setup time, events/s and RSS versus STA count.")
+    ap.add_argument("--ns3-dir", default=".", help="ns-3 root directory (working directory of every run)")
+    ap.add_argument("--binary", default=None,
+                    help="fairness11ax executable (default: search <ns3-dir>/build/scratch)")
+    ap.add_argument("--sizes", type=int, nargs="+", default=[10, 50, 100, 200, 500], help="Total STA counts")
+    ap.add_argument("--he-fraction", type=float, default=0.8, help="Share of HE STAs in every mix")
+    ap.add_argument("--simTime", type=float, default=0.5)
+    ap.add_argument("--payloadSize", type=int, default=1000)
+    ap.add_argument("--lambda", dest="lambda_sta", type=float, default=100,
+                    help="Packets/s per STA (kept low so the run measures per-STA cost, not saturation)")
+    ap.add_argument("--placement", default="disc", choices=["line", "disc"])
+    ap.add_argument("--radius", type=float, default=10.0, help="Disc radius (m)")
+    ap.add_argument("--run", type=int, default=1, help="RngRun of every size")
+    ap.add_argument("--csv", default=None, help="Also write the table to this CSV file")
+    ap.add_argument("-v", "--verbose", action="store_true")
+    ap.add_argument("--extra-args", nargs=argparse.REMAINDER, default=[],
+                    help="Remaining arguments are passed verbatim to fairness11ax")
+    args = ap.parse_args()
+
+    args.ns3_dir = os.path.abspath(args.ns3_dir)
+    if args.binary is None:
+        args.binary = sweep.find_binary(args.ns3_dir)
+    if not args.binary:
+        print("fairness11ax binary not found; build it or pass --binary", file=sys.stderr)
+        return 2
+    args.binary = os.path.abspath(args.binary)
+
+    rows = []
+    print("{:>7} {:>7} {:>5} {:>10} {:>10} {:>12} {:>12} {:>11}".format(
+        "nTotal", "nLegacy", "mHe", "setup[s]", "run[s]", "events", "events/s", "maxRSS[KB]"))
+    for n in args.sizes:
+        try:
+            row = run_size(args, n)
+        except RuntimeError as e:
+            print(e, file=sys.stderr)
+            return 1
+        rows.append(row)
+        print("{nTotal:>7} {nLegacy:>7} {mHe:>5} {setup_wall_s:>10.3f} {run_wall_s:>10.3f} "
+              "{events:>12} {events_per_s:>12.0f} {max_rss_kb:>11}".format(**row), flush=True)
+
+    if args.csv:
+        with open(args.csv, "w", newline="", encoding="utf-8") as f:
+            w = csv.DictWriter(f, fieldnames=COLUMNS)
+            w.writeheader()
+            w.writerows(rows)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
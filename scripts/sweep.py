@@ -0,0 +1,655 @@
+#!/usr/bin/env python3
+"""
+Parallel driver for the (mu x CW pair x RngRun) sweep grid of fairness11ax.
+
+Every (mu, cwmin, cwmax, run) is an independent job. Jobs are handed to a pool
+of workers, each one running the fairness11ax binary for a single RngRun and
+writing its output atomically to
+
+    <outdir>/runs/nL<nL>_mH<mH>/mu<mu>/cw<cwmin>_<cwmax>/run<i>.txt
+
+Outputs that already exist are skipped, so an interrupted sweep resumes where
+it stopped. Once all runs are present, the per-mu files expected by
+plot_results.py (fairness_nLegacy*_mHe*_mu*.txt) are assembled from them, in
+the same layout as run_fairness_sweep.sh, with the fairness-aggregate tool
+when it is built (process.awk otherwise).
+
+With --adaptive, the number of runs per point is not fixed: runs are added in
+batches of --batch, and a point stops once the CI half-widths (from
+fairness-aggregate) of network throughput and of the per-run Jain_group are
+below their targets, or after --max-runs runs.
+
+With --cache DIR, finished runs are also stored in a content-addressed cache
+shared between sweeps (and output directories):
+
+    <cache>/<key[:2]>/<key>.txt   (run output)
+    <cache>/<key[:2]>/<key>.json  (what the key was computed from)
+
+where key is the SHA-256 of the canonical scenario arguments of the run
+(every --name=value passed to fairness11ax, RngRun included, sorted, numbers
+normalised so that 0.10 and 0.1 match) and of the build identity (SHA-256 of
+the binary, or of the scratch sources when running through ./ns3, plus the
+ns-3 version). A job whose key is cached is published from the cache instead
+of being simulated, so overlapping grids only simulate the missing points.
+
+With --screen, an early-screening stage runs before the full replication
+budget and drops the points that cannot be the best feasible pair of their mu
+(Jain_group >= --eta, as compute_best_feasible in plot_results.py):
+
+  1. Model: the analytical model (ul-ofdma-model --screen) predicts every
+     point; a predicted Jain_group below eta - --screen-model-margin prunes it.
+  2. Short runs: the other points get --screen-runs runs of --screen-simtime
+     seconds (under <outdir>/screen). Bounds are the aggregator's CI
+     half-widths at --conf: Jain_group +- jain_run_ci widened by
+     --screen-margin, throughput +- thr_total_ci widened by
+     --screen-thr-margin (relative). A point is pruned if its Jain upper
+     bound is below eta (infeasible), or if its throughput upper bound is
+     below the throughput lower bound of a pair of the same mu whose Jain
+     lower bound is at least eta (dominated).
+
+Only the surviving points are then run (fixed or adaptive). Every decision
+and its bounds are written to <outdir>/screen_nL*_mH*.csv, and the blocks of
+pruned points in the per-mu files carry a "# screen:" line instead of results.
+"""
+import argparse
+import csv
+import glob
+import hashlib
+import io
+import json
+import os
+import shutil
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from dataclasses import dataclass
+from typing import List, Optional, Sequence
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# Same grid as run_fairness_sweep.sh
+DEFAULT_MU_INTERVALS = ["0.0", "0.1", "0.05", "0.01", "0.001"]
+DEFAULT_CW_PAIRS = ["15:1023", "15:512", "15:256", "7:128", "7:63", "3:63", "3:31", "3:15"]
+
+RESULTS_MARKER = "=== Results (uplink only) ==="
+
+
+# -----------------------------
+# Jobs
+# -----------------------------
+
+@dataclass(frozen=True)
+class Job:
+    mu: str
+    cwmin: int
+    cwmax: int
+    run: int
+
+
+def point_dir(outdir: str, n_legacy: int, m_he: int, mu: str, cwmin: int, cwmax: int) -> str:
+    return os.path.join(outdir, "runs", f"nL{n_legacy}_mH{m_he}", f"mu{mu}", f"cw{cwmin}_{cwmax}")
+
+
+def job_output(args: argparse.Namespace, job: Job) -> str:
+    return os.path.join(point_dir(args.outdir, args.nLegacy, args.mHe, job.mu, job.cwmin, job.cwmax),
+                        f"run{job.run}.txt")
+
+
+def parse_cw_pairs(pairs: Sequence[str]) -> List[tuple]:
+    out = []
+    for p in pairs:
+        cwmin, cwmax = p.split(":")
+        out.append((int(cwmin), int(cwmax)))
+    return out
+
+
+def build_grid(mus: Sequence[str], cw_pairs: Sequence[tuple], runs: Sequence[int]) -> List[Job]:
+    return [Job(mu, cwmin, cwmax, run) for mu in mus for (cwmin, cwmax) in cw_pairs for run in runs]
+
+
+# -----------------------------
+# Running fairness11ax
+# -----------------------------
+
+def find_binary(ns3_dir: str, program: str = "fairness11ax") -> Optional[str]:
+    """Locate a built scratch program (build/scratch/ns3.*-<program>-<profile>)."""
+    hits = sorted(glob.glob(os.path.join(ns3_dir, "build", "scratch", "**", f"ns3*-{program}-*"),
+                            recursive=True))
+    hits = [h for h in hits if os.access(h, os.X_OK) and not h.endswith(".o")]
+    return hits[0] if hits else None
+
+
+def scenario_args(args: argparse.Namespace, job: Job) -> List[str]:
+    out = [
+        f"--nLegacy={args.nLegacy}",
+        f"--mHe={args.mHe}",
+        f"--simTime={args.simTime}",
+        f"--payloadSize={args.payloadSize}",
+        f"--lambdaLegacy={args.lambdaLegacy}",
+        f"--lambdaHe={args.lambdaHe}",
+        f"--apCwMin={job.cwmin}",
+        f"--apCwMax={job.cwmax}",
+        f"--muAccessReqInterval={job.mu}",
+        f"--RngRun={job.run}",
+    ]
+    out.extend(args.extra_args)
+    return out
+
+
+def job_command(args: argparse.Namespace, job: Job) -> List[str]:
+    if args.binary:
+        return [args.binary] + scenario_args(args, job)
+    # Fall back to the ns3 wrapper (slower: one wrapper start per job).
+    return [os.path.join(args.ns3_dir, "ns3"), "run", "--no-build",
+            " ".join(["fairness11ax"] + scenario_args(args, job))]
+
+
+# -----------------------------
+# Result cache (--cache)
+# -----------------------------
+
+def file_sha256(path: str) -> str:
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            h.update(block)
+    return h.hexdigest()
+
+
+def ns3_version(ns3_dir: str) -> str:
+    """ns-3 release (VERSION file) and, for a git checkout, the described commit."""
+    parts = []
+    version_file = os.path.join(ns3_dir, "VERSION")
+    if os.path.exists(version_file):
+        with open(version_file, "r", encoding="utf-8", errors="ignore") as f:
+            parts.append(f.read().strip())
+    try:
+        proc = subprocess.run(["git", "-C", ns3_dir, "describe", "--always", "--dirty"],
+                              stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+        if proc.returncode == 0:
+            parts.append(proc.stdout.strip())
+    except OSError:
+        pass
+    return " ".join(parts) or "unknown"
+
+
+def build_identity(args: argparse.Namespace) -> dict:
+    """What decides the output of a run besides its arguments."""
+    ident = {"ns3": ns3_version(args.ns3_dir)}
+    if args.binary:
+        ident["binary_sha256"] = file_sha256(args.binary)
+    else:
+        # ./ns3 run rebuilds from the scratch sources: hash those instead.
+        scratch = os.path.join(args.ns3_dir, "scratch")
+        ident["scratch_sha256"] = {
+            os.path.relpath(p, scratch): file_sha256(p)
+            for p in sorted(glob.glob(os.path.join(scratch, "*.cc")) + glob.glob(os.path.join(scratch, "*.h")))
+        }
+    return ident
+
+
+def canonical_value(v: str) -> str:
+    try:
+        f = float(v)
+    except ValueError:
+        return v
+    return repr(int(f)) if f.is_integer() and abs(f) < 2 ** 53 else repr(f)
+
+
+def canonical_args(argv: Sequence[str]) -> dict:
+    """--name=value arguments as a sorted dict (positional ones kept in order)."""
+    named = {}
+    positional = []
+    for a in argv:
+        if a.startswith("--") and "=" in a:
+            k, v = a[2:].split("=", 1)
+            named[k] = canonical_value(v)
+        elif a.startswith("--"):
+            named[a[2:]] = "true"
+        else:
+            positional.append(a)
+    out = dict(sorted(named.items()))
+    if positional:
+        out[""] = positional
+    return out
+
+
+def cache_key(args: argparse.Namespace, job: Job) -> tuple:
+    meta = {"args": canonical_args(scenario_args(args, job)), "build": args.build_id}
+    blob = json.dumps(meta, sort_keys=True, separators=(",", ":")).encode()
+    return hashlib.sha256(blob).hexdigest(), meta
+
+
+def cache_path(args: argparse.Namespace, key: str) -> str:
+    return os.path.join(args.cache, key[:2], key + ".txt")
+
+
+def publish(src: str, dst: str) -> None:
+    """Atomically make dst a copy of src (a hard link when possible)."""
+    os.makedirs(os.path.dirname(dst), exist_ok=True)
+    tmp = f"{dst}.tmp.{os.getpid()}"
+    try:
+        os.link(src, tmp)
+    except OSError:
+        shutil.copyfile(src, tmp)
+    os.replace(tmp, dst)
+
+
+def cache_fetch(args: argparse.Namespace, job: Job) -> bool:
+    if not args.cache:
+        return False
+    path = cache_path(args, cache_key(args, job)[0])
+    if not os.path.exists(path):
+        return False
+    publish(path, job_output(args, job))
+    return True
+
+
+def cache_store(args: argparse.Namespace, job: Job, output: str) -> None:
+    key, meta = cache_key(args, job)
+    path = cache_path(args, key)
+    publish(output, path)
+    tmp = f"{path[:-4]}.json.tmp.{os.getpid()}"
+    with open(tmp, "w", encoding="utf-8") as f:
+        json.dump(meta, f, sort_keys=True, indent=1)
+    os.replace(tmp, path[:-4] + ".json")
+
+
+def run_job(args: argparse.Namespace, job: Job) -> Optional[str]:
+    """Run one job; returns None on success or an error string."""
+    final = job_output(args, job)
+    os.makedirs(os.path.dirname(final), exist_ok=True)
+    tmp = f"{final}.tmp.{os.getpid()}"
+
+    with open(tmp, "w", encoding="utf-8") as f:
+        proc = subprocess.run(job_command(args, job), cwd=args.ns3_dir, stdout=f,
+                              stderr=subprocess.PIPE, text=True)
+    if proc.returncode != 0:
+        os.unlink(tmp)
+        return f"exit code {proc.returncode}: {proc.stderr.strip()[-500:]}"
+
+    with open(tmp, "r", encoding="utf-8", errors="ignore") as f:
+        if RESULTS_MARKER not in f.read():
+            os.unlink(tmp)
+            return "no result block in output"
+
+    # Atomic publish: a partially written run is never mistaken for a finished one.
+    os.replace(tmp, final)
+    if args.cache:
+        cache_store(args, job, final)
+    return None
+
+
+def run_jobs(args: argparse.Namespace, jobs: Sequence[Job]) -> int:
+    """Run all jobs whose output is missing. Returns the number of failures."""
+    pending = [j for j in jobs if not os.path.exists(job_output(args, j))]
+    done = len(jobs) - len(pending)
+    cached = 0
+    if args.cache:
+        missing = [j for j in pending if not cache_fetch(args, j)]
+        cached = len(pending) - len(missing)
+        pending = missing
+        done += cached
+    print(f"{len(jobs)} jobs, {done - cached} already done, {cached} from cache, {len(pending)} to run "
+          f"on {args.jobs} workers", file=sys.stderr)
+
+    failures = 0
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = {pool.submit(run_job, args, j): j for j in pending}
+        for fut in as_completed(futures):
+            job = futures[fut]
+            err = fut.result()
+            done += 1
+            if err:
+                failures += 1
+                print(f"[{done}/{len(jobs)}] FAILED mu={job.mu} cw={job.cwmin}:{job.cwmax} "
+                      f"run={job.run}: {err}", file=sys.stderr)
+            elif args.verbose:
+                print(f"[{done}/{len(jobs)}] mu={job.mu} cw={job.cwmin}:{job.cwmax} run={job.run}",
+                      file=sys.stderr)
+    return failures
+
+
+# -----------------------------
+# Assembling per-mu files
+# -----------------------------
+
+def summarize_point(args: argparse.Namespace, run_files: Sequence[str]) -> str:
+    if args.aggregator:
+        cmd = [args.aggregator]
+    else:
+        cmd = [args.awk, "-f", os.path.join(SCRIPT_DIR, "process.awk")]
+    proc = subprocess.run(cmd + list(run_files), stdout=subprocess.PIPE, check=True, text=True)
+    return proc.stdout
+
+
+def assemble(args: argparse.Namespace, mus: Sequence[str], cw_pairs: Sequence[tuple],
+             runs: Sequence[int], runs_label: Optional[str] = None, notes: Optional[dict] = None) -> None:
+    """notes: (mu, cwmin, cwmax) -> text written into the block of a point that has no runs."""
+    for mu in mus:
+        out_file = os.path.join(args.outdir, f"fairness_nLegacy{args.nLegacy}_mHe{args.mHe}_mu{mu}.txt")
+        tmp = out_file + ".tmp"
+        with open(tmp, "w", encoding="utf-8") as f:
+            f.write("===== Sweep configuration =====\n")
+            f.write(f"nLegacy             = {args.nLegacy}\n")
+            f.write(f"mHe                 = {args.mHe}\n")
+            f.write(f"simTime             = {args.simTime}\n")
+            f.write(f"payloadSize         = {args.payloadSize}\n")
+            f.write(f"lambdaLegacy        = {args.lambdaLegacy}\n")
+            f.write(f"lambdaHe            = {args.lambdaHe}\n")
+            f.write(f"muAccessReqInterval = {mu}\n")
+            f.write(f"RngRuns             = {runs_label or f'{runs[0]}..{runs[-1]}'}\n")
+            f.write("===============================\n\n")
+
+            for cwmin, cwmax in cw_pairs:
+                files = [job_output(args, Job(mu, cwmin, cwmax, r)) for r in runs]
+                files = [p for p in files if os.path.exists(p)]
+                f.write(f"----- AP_CWMIN={cwmin} AP_CWMAX={cwmax} -----\n")
+                if files:
+                    f.write(summarize_point(args, files))
+                elif notes and (mu, cwmin, cwmax) in notes:
+                    f.write(f"# screen: {notes[(mu, cwmin, cwmax)]}\n")
+                f.write("\n")
+        os.replace(tmp, out_file)
+        print(f"Wrote {out_file}", file=sys.stderr)
+
+
+# -----------------------------
+# Adaptive (sequential) stopping
+# -----------------------------
+
+def runs_present(args: argparse.Namespace, mu: str, cwmin: int, cwmax: int) -> int:
+    """Number of consecutive finished runs 0, 1, ... of a point."""
+    n = 0
+    while os.path.exists(job_output(args, Job(mu, cwmin, cwmax, n))):
+        n += 1
+    return n
+
+
+def point_ci(args: argparse.Namespace, mu: str, cwmin: int, cwmax: int, n: int) -> dict:
+    """fairness-aggregate CSV row of one point over runs 0..n-1."""
+    files = [job_output(args, Job(mu, cwmin, cwmax, r)) for r in range(n)]
+    proc = subprocess.run([args.aggregator, "--format=csv", f"--conf={args.conf}"] + files,
+                          stdout=subprocess.PIPE, check=True, text=True)
+    rows = list(csv.DictReader(io.StringIO(proc.stdout)))
+    if len(rows) != 1:
+        raise RuntimeError(f"expected one point from the aggregator, got {len(rows)}")
+    return rows[0]
+
+
+def converged(args: argparse.Namespace, row: dict) -> bool:
+    thr, thr_ci = float(row["thr_total_mbps"]), float(row["thr_total_ci"])
+    jain_ci = float(row["jain_run_ci"])
+    return thr_ci <= args.target_ci_thr * abs(thr) and jain_ci <= args.target_ci_jain
+
+
+def run_adaptive(args: argparse.Namespace, mus: Sequence[str], cw_pairs: Sequence[tuple],
+                 keep: Optional[set] = None) -> int:
+    """
+    Rounds over all unfinished points: every round evaluates each point and
+    submits its next batch of runs, so the pool stays busy across points.
+    keep restricts the grid to those (mu, cwmin, cwmax) points.
+    Returns the number of failed jobs. Writes <outdir>/adaptive_nL*_mH*.csv.
+    """
+    points = [(mu, cwmin, cwmax) for mu in mus for (cwmin, cwmax) in cw_pairs
+              if keep is None or (mu, cwmin, cwmax) in keep]
+    final = {}
+    failures = 0
+    while True:
+        jobs = []
+        for p in points:
+            if p in final:
+                continue
+            n = runs_present(args, *p)
+            if n >= args.min_runs:
+                row = point_ci(args, *p, n)
+                if converged(args, row) or n >= args.max_runs:
+                    final[p] = (n, row, converged(args, row))
+                    continue
+            target = min(max(n + args.batch, args.min_runs), args.max_runs)
+            jobs.extend(Job(p[0], p[1], p[2], r) for r in range(n, target))
+        if not jobs:
+            break
+        round_failures = run_jobs(args, jobs)
+        if round_failures:
+            failures += round_failures
+            # A failing run would be retried forever; leave it for a rerun.
+            break
+
+    summary = os.path.join(args.outdir, f"adaptive_nL{args.nLegacy}_mH{args.mHe}.csv")
+    with open(summary, "w", encoding="utf-8", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["mu", "cwmin", "cwmax", "runs", "thr_total_mbps", "thr_total_ci", "jain_run_mean",
+                    "jain_run_ci", "converged"])
+        for p in points:
+            if p not in final:
+                continue
+            n, row, ok = final[p]
+            w.writerow([p[0], p[1], p[2], n, row["thr_total_mbps"], row["thr_total_ci"],
+                        row["jain_run_mean"], row["jain_run_ci"], int(ok)])
+    total = sum(v[0] for v in final.values())
+    print(f"adaptive: {len(final)}/{len(points)} points finished with {total} runs "
+          f"({sum(1 for v in final.values() if v[2])} converged); summary in {summary}", file=sys.stderr)
+    return failures
+
+
+# -----------------------------
+# Early screening (--screen)
+# -----------------------------
+
+def model_predictions(args: argparse.Namespace, mus: Sequence[str], cw_pairs: Sequence[tuple]) -> dict:
+    """ul-ofdma-model --screen predictions of the grid: (mu, cwmin, cwmax) -> (thr, jain)."""
+    values = sorted({v for pair in cw_pairs for v in pair})
+    cmd = [args.model_bin, "--screen", f"--nL={args.nLegacy}", f"--nH={args.mHe}",
+           "--mu=" + ",".join(mus), "--cw=" + ",".join(str(v) for v in values),
+           f"--payloadSize={args.payloadSize}"]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, check=True, text=True)
+    rows = {}
+    for row in csv.DictReader(io.StringIO(proc.stdout)):
+        key = (round(float(row["mu"]), 12), int(float(row["apCwMin"])), int(float(row["apCwMax"])))
+        rows[key] = (float(row["thr_total_mbps"]), float(row["jain_group"]))
+    out = {}
+    for mu in mus:
+        for cwmin, cwmax in cw_pairs:
+            pred = rows.get((round(float(mu), 12), cwmin, cwmax))
+            if pred is not None:
+                out[(mu, cwmin, cwmax)] = pred
+    return out
+
+
+def screen_namespace(args: argparse.Namespace) -> argparse.Namespace:
+    """Arguments of the short screening runs: own output tree, shorter simTime."""
+    s = argparse.Namespace(**vars(args))
+    s.outdir = os.path.join(args.outdir, "screen")
+    s.simTime = args.screen_simtime
+    return s
+
+
+def run_screen(args: argparse.Namespace, mus: Sequence[str], cw_pairs: Sequence[tuple]) -> tuple:
+    """
+    Model and short-run screening of the grid. Returns (keep, notes, failures):
+    the surviving points, the pruning reason per pruned point and the number
+    of failed screening jobs. Points whose screening runs are missing are kept.
+    Writes <outdir>/screen_nL*_mH*.csv.
+    """
+    points = [(mu, cwmin, cwmax) for mu in mus for (cwmin, cwmax) in cw_pairs]
+    model = model_predictions(args, mus, cw_pairs) if args.model_bin else {}
+    log = {p: {"model": model.get(p), "runs": 0, "bounds": None, "reason": ""} for p in points}
+
+    for p, pred in model.items():
+        if pred[1] < args.eta - args.screen_model_margin:
+            log[p]["reason"] = "model_infeasible"
+
+    sargs = screen_namespace(args)
+    pending = [p for p in points if not log[p]["reason"]]
+    failures = run_jobs(sargs, [Job(*p, r) for p in pending for r in range(args.screen_runs)])
+
+    for p in pending:
+        n = min(runs_present(sargs, *p), args.screen_runs)
+        log[p]["runs"] = n
+        if n < 2:
+            continue
+        row = point_ci(sargs, *p, n)
+        thr, thr_ci = float(row["thr_total_mbps"]), float(row["thr_total_ci"])
+        jain, jain_ci = float(row["jain_group"]), float(row["jain_run_ci"])
+        bounds = ((thr - thr_ci) * (1.0 - args.screen_thr_margin), (thr + thr_ci) * (1.0 + args.screen_thr_margin),
+                  jain - jain_ci - args.screen_margin, jain + jain_ci + args.screen_margin)
+        log[p]["bounds"] = (thr, jain) + bounds
+        if bounds[3] < args.eta:
+            log[p]["reason"] = "infeasible"
+
+    # Dominance per mu, against the confidently feasible point with the best
+    # throughput lower bound (which is always kept).
+    for mu in mus:
+        feasible = [p for p in points if p[0] == mu and log[p]["bounds"] and log[p]["bounds"][4] >= args.eta]
+        if not feasible:
+            continue
+        best = max(feasible, key=lambda p: log[p]["bounds"][2])
+        for p in points:
+            b = log[p]["bounds"]
+            if p[0] == mu and not log[p]["reason"] and b and p != best and b[3] < log[best]["bounds"][2]:
+                log[p]["reason"] = f"dominated_by_{best[1]}:{best[2]}"
+
+    os.makedirs(args.outdir, exist_ok=True)
+    summary = os.path.join(args.outdir, f"screen_nL{args.nLegacy}_mH{args.mHe}.csv")
+    with open(summary, "w", encoding="utf-8", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["mu", "cwmin", "cwmax", "model_thr_mbps", "model_jain", "screen_runs", "screen_simtime",
+                    "thr_total_mbps", "thr_lo", "thr_hi", "jain_group", "jain_lo", "jain_hi", "eta",
+                    "decision", "reason"])
+        for p in points:
+            e = log[p]
+            model_cols = [f"{v:.6f}" for v in e["model"]] if e["model"] else ["", ""]
+            bound_cols = [f"{v:.6f}" for v in e["bounds"]] if e["bounds"] else [""] * 6
+            w.writerow([p[0], p[1], p[2]] + model_cols + [e["runs"], args.screen_simtime] + bound_cols +
+                       [args.eta, "prune" if e["reason"] else "keep", e["reason"]])
+
+    notes = {p: f"pruned ({log[p]['reason']}), see {os.path.basename(summary)}" for p in points if log[p]["reason"]}
+    keep = {p for p in points if not log[p]["reason"]}
+    by_reason = {}
+    for p in notes:
+        kind = log[p]["reason"].split("_by_")[0]
+        by_reason[kind] = by_reason.get(kind, 0) + 1
+    detail = ", ".join(f"{k} {v}" for k, v in sorted(by_reason.items()))
+    print(f"screen: {len(keep)}/{len(points)} points kept" + (f" ({detail} pruned)" if detail else "") +
+          f"; log in {summary}", file=sys.stderr)
+    return keep, notes, failures
+
+
+# -----------------------------
+# Main
+# -----------------------------
+
+def add_common_arguments(ap: argparse.ArgumentParser) -> None:
+    """Tool locations and scenario parameters shared with cw_search.py."""
+    ap.add_argument("--ns3-dir", default=".", help="ns-3 root directory (working directory of every job)")
+    ap.add_argument("--binary", default=None,
+                    help="fairness11ax executable (default: search <ns3-dir>/build/scratch, else use ./ns3 run)")
+    ap.add_argument("--outdir", default="sweep-output", help="Directory for per-run outputs and per-mu files")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1, help="Number of parallel workers")
+    ap.add_argument("--aggregator", default=None,
+                    help="fairness-aggregate executable (default: search <ns3-dir>/build/scratch)")
+    ap.add_argument("--awk", default=shutil.which("gawk") or "awk",
+                    help="awk used to run process.awk (GNU awk) when no aggregator is found")
+    ap.add_argument("--nLegacy", type=int, default=2)
+    ap.add_argument("--mHe", type=int, default=8)
+    ap.add_argument("--simTime", type=float, default=1)
+    ap.add_argument("--payloadSize", type=int, default=1000)
+    ap.add_argument("--lambdaLegacy", type=float, default=5000)
+    ap.add_argument("--lambdaHe", type=float, default=5000)
+    ap.add_argument("--cache", default=os.environ.get("FAIRNESS_CACHE"),
+                    help="Content-addressed run cache shared between sweeps (default: $FAIRNESS_CACHE, none if unset)")
+    ap.add_argument("-v", "--verbose", action="store_true")
+
+
+def resolve_tools(args: argparse.Namespace) -> None:
+    args.ns3_dir = os.path.abspath(args.ns3_dir)
+    args.outdir = os.path.abspath(args.outdir)
+    if args.binary is None:
+        args.binary = find_binary(args.ns3_dir)
+    if args.binary:
+        args.binary = os.path.abspath(args.binary)
+    if args.aggregator is None:
+        args.aggregator = find_binary(args.ns3_dir, "fairness-aggregate")
+    if args.aggregator:
+        args.aggregator = os.path.abspath(args.aggregator)
+    if args.cache:
+        args.cache = os.path.abspath(args.cache)
+        args.build_id = build_identity(args)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Run the fairness11ax (mu x CW pair x RngRun) grid on a worker pool.")
+    add_common_arguments(ap)
+    ap.add_argument("--mu", nargs="+", default=DEFAULT_MU_INTERVALS, help="muAccessReqInterval values")
+    ap.add_argument("--cw", nargs="+", default=DEFAULT_CW_PAIRS, help="CW pairs as CWMIN:CWMAX")
+    ap.add_argument("--runs", type=int, default=30, help="Simulate RngRun 0..RUNS (inclusive, as N_RUNS)")
+    ap.add_argument("--adaptive", action="store_true",
+                    help="Sequential stopping: add runs per point until the CI targets are met (needs the aggregator)")
+    ap.add_argument("--batch", type=int, default=4, help="Adaptive: runs added to a point per round")
+    ap.add_argument("--min-runs", type=int, default=8, help="Adaptive: runs before the first CI check")
+    ap.add_argument("--max-runs", type=int, default=60, help="Adaptive: upper bound on runs per point")
+    ap.add_argument("--conf", type=float, default=0.95, help="Adaptive: confidence level of the CIs")
+    ap.add_argument("--target-ci-thr", type=float, default=0.01,
+                    help="Adaptive: network-throughput CI half-width target, relative to the mean")
+    ap.add_argument("--target-ci-jain", type=float, default=0.005,
+                    help="Adaptive: per-run Jain_group CI half-width target (absolute)")
+    ap.add_argument("--screen", action="store_true",
+                    help="Prune infeasible or dominated points with the model and short runs first (needs the aggregator)")
+    ap.add_argument("--eta", type=float, default=0.95, help="Screen: fairness threshold (Jain_group >= eta)")
+    ap.add_argument("--model-bin", default=None,
+                    help="Screen: ul-ofdma-model executable (default: search <ns3-dir>/build/scratch, else no model stage)")
+    ap.add_argument("--screen-model-margin", type=float, default=0.1,
+                    help="Screen: prune points whose model Jain_group is below eta minus this margin")
+    ap.add_argument("--screen-runs", type=int, default=4, help="Screen: short runs per point")
+    ap.add_argument("--screen-simtime", type=float, default=None,
+                    help="Screen: simTime of the short runs (default: a quarter of --simTime)")
+    ap.add_argument("--screen-margin", type=float, default=0.02,
+                    help="Screen: absolute widening of the Jain_group bounds of the short runs")
+    ap.add_argument("--screen-thr-margin", type=float, default=0.05,
+                    help="Screen: relative widening of the throughput bounds of the short runs")
+    ap.add_argument("--no-assemble", action="store_true", help="Only run the jobs, do not write per-mu files")
+    ap.add_argument("--extra-args", nargs=argparse.REMAINDER, default=[],
+                    help="Further fairness11ax arguments, passed verbatim (must come last)")
+    args = ap.parse_args()
+    resolve_tools(args)
+
+    cw_pairs = parse_cw_pairs(args.cw)
+    keep, notes, failures = None, None, 0
+    if args.screen:
+        if not args.aggregator:
+            ap.error("--screen needs the fairness-aggregate tool (--aggregator)")
+        if args.screen_runs < 2:
+            ap.error("--screen-runs must be at least 2 (the bounds are confidence intervals)")
+        if args.screen_simtime is None:
+            args.screen_simtime = args.simTime / 4
+        if args.model_bin is None:
+            args.model_bin = find_binary(args.ns3_dir, "ul-ofdma-model")
+        if args.model_bin:
+            args.model_bin = os.path.abspath(args.model_bin)
+        else:
+            print("screen: ul-ofdma-model not found, skipping the model stage", file=sys.stderr)
+        keep, notes, failures = run_screen(args, args.mu, cw_pairs)
+
+    if args.adaptive:
+        if not args.aggregator:
+            ap.error("--adaptive needs the fairness-aggregate tool (--aggregator)")
+        failures += run_adaptive(args, args.mu, cw_pairs, keep)
+        runs = list(range(0, args.max_runs))
+        runs_label = f"adaptive (<= {args.max_runs})"
+    else:
+        runs = list(range(0, args.runs + 1))
+        runs_label = None
+        grid = build_grid(args.mu, cw_pairs, runs)
+        failures += run_jobs(args, [j for j in grid if keep is None or (j.mu, j.cwmin, j.cwmax) in keep])
+    if failures:
+        print(f"{failures} job(s) failed; rerun to retry them (finished runs are kept).", file=sys.stderr)
+
+    if not args.no_assemble:
+        assemble(args, args.mu, cw_pairs, runs, runs_label, notes)
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Validation of fairness11ax --phyModel=abstract against --phyModel=spectrum.
+
+Runs the same (mix x mu x CW pair x RngRun) grid with both PHY models through
+sweep.py's job runner (outputs under <outdir>/phy<model>/, so reruns and
+--cache work as for sweep.py), reduces every point with process.awk and
+compares the two (fairness-aggregate is used instead of process.awk when
+it is built, as in sweep.py; both print the same metrics):
+
+    network throughput: |abstract - spectrum| <= --tol-thr * spectrum
+    Jain_group:         |abstract - spectrum| <= --tol-jain
+
+A per-point table is printed (followed by the wall time of each model's
+batch) and written to <outdir>/phy_validation.csv. Exit code 1 when any
+point is out of tolerance. The abstract model only memoises the error model
+(the PSD interference path is unchanged), so expect a speed-up close to 1x;
+the wall times are the measurement of it.
+
+Example:
+
+    python3 scripts/validate_phy.py --ns3-dir ~/ns-3.46 --runs 9 -j 32
+"""
+import argparse
+import copy
+import csv
+import os
+import re
+import sys
+import time
+from typing import Dict, List, Tuple
+
+import sweep
+
+NET_RE = re.compile(r"Network throughput \(sum of per-STA mean\) = ([0-9.eE+-]+) Mbps")
+JAIN_RE = re.compile(r"Jain_group \(HE vs Legacy\) = ([0-9.eE+-]+)")
+
+MODELS = ["spectrum", "abstract"]
+
+
+def model_args(args: argparse.Namespace, model: str, n_legacy: int, m_he: int) -> argparse.Namespace:
+    a = copy.copy(args)
+    a.nLegacy, a.mHe = n_legacy, m_he
+    a.outdir = os.path.join(args.outdir, f"phy{model}")
+    a.extra_args = list(args.extra_args) + [f"--phyModel={model}"]
+    return a
+
+
+def point_metrics(a: argparse.Namespace, mu: str, cwmin: int, cwmax: int, runs: List[int]) -> Tuple[float, float]:
+    files = [sweep.job_output(a, sweep.Job(mu, cwmin, cwmax, r)) for r in runs]
+    files = [f for f in files if os.path.exists(f)]
+    if not files:
+        raise RuntimeError(f"no runs for mu={mu} cw={cwmin}:{cwmax} in {a.outdir}")
+    # process.awk metrics (fairness-aggregate prints the same lines when built)
+    out = sweep.summarize_point(a, files)
+    net, jain = NET_RE.search(out), JAIN_RE.search(out)
+    if not net or not jain:
+        raise RuntimeError("unexpected process.awk output")
+    return float(net.group(1)), float(jain.group(1))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Compare fairness11ax abstract and spectrum PHY models.")
+    sweep.add_common_arguments(ap)
+    ap.add_argument("--mixes", nargs="+", default=["2:8", "5:5", "8:2"], help="Populations as NLEGACY:MHE")
+    ap.add_argument("--mu", nargs="+", default=["0", "0.01"], help="muAccessReqInterval values")
+    ap.add_argument("--cw", nargs="+", default=["15:1023", "7:63"], help="CW pairs as CWMIN:CWMAX")
+    ap.add_argument("--runs", type=int, default=5, help="RngRun 0..RUNS-1 per point")
+    ap.add_argument("--tol-thr", type=float, default=0.03, help="Relative network-throughput tolerance")
+    ap.add_argument("--tol-jain", type=float, default=0.01, help="Absolute Jain_group tolerance")
+    ap.add_argument("--extra-args", nargs=argparse.REMAINDER, default=[],
+                    help="Further fairness11ax arguments for both models, passed verbatim (must come last)")
+    args = ap.parse_args()
+    args.outdir = args.outdir if args.outdir != "sweep-output" else "phy-validation"
+    sweep.resolve_tools(args)
+    if not args.binary:
+        ap.error("fairness11ax binary not found; build it or pass --binary")
+
+    mixes = [tuple(int(x) for x in m.split(":")) for m in args.mixes]
+    cw_pairs = sweep.parse_cw_pairs(args.cw)
+    runs = list(range(args.runs))
+
+    wall: Dict[str, float] = {}
+    failures = 0
+    for model in MODELS:
+        t0 = time.monotonic()
+        for nl, mh in mixes:
+            failures += sweep.run_jobs(model_args(args, model, nl, mh), sweep.build_grid(args.mu, cw_pairs, runs))
+        wall[model] = time.monotonic() - t0
+    if failures:
+        print(f"{failures} job(s) failed; rerun to retry them.", file=sys.stderr)
+        return 1
+
+    rows = []
+    bad = 0
+    print("{:>7} {:>6} {:>9} {:>12} {:>12} {:>7} {:>9} {:>9} {:>7}  ok".format(
+        "mix", "mu", "cw", "thr_spec", "thr_abs", "dthr%", "jain_spec", "jain_abs", "djain"))
+    for nl, mh in mixes:
+        for mu in args.mu:
+            for cwmin, cwmax in cw_pairs:
+                spec = point_metrics(model_args(args, "spectrum", nl, mh), mu, cwmin, cwmax, runs)
+                abst = point_metrics(model_args(args, "abstract", nl, mh), mu, cwmin, cwmax, runs)
+                dthr = (abst[0] - spec[0]) / spec[0] if spec[0] > 0 else 0.0
+                djain = abst[1] - spec[1]
+                ok = abs(dthr) <= args.tol_thr and abs(djain) <= args.tol_jain
+                bad += not ok
+                rows.append([nl, mh, mu, cwmin, cwmax, spec[0], abst[0], dthr, spec[1], abst[1], djain, int(ok)])
+                print(f"{nl:>3}/{mh:<3} {mu:>6} {cwmin:>4}:{cwmax:<4} {spec[0]:>12.4f} {abst[0]:>12.4f} "
+                      f"{100 * dthr:>+7.2f} {spec[1]:>9.4f} {abst[1]:>9.4f} {djain:>+7.4f}  {'yes' if ok else 'NO'}")
+
+    os.makedirs(args.outdir, exist_ok=True)
+    out = os.path.join(args.outdir, "phy_validation.csv")
+    with open(out, "w", encoding="utf-8", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["nLegacy", "mHe", "mu", "cwmin", "cwmax", "thr_spectrum_mbps", "thr_abstract_mbps", "thr_rel_diff",
+                    "jain_spectrum", "jain_abstract", "jain_diff", "within_tolerance"])
+        w.writerows(rows)
+    print(f"\nwall: " + "  ".join(f"{m}={wall[m]:.1f}s" for m in MODELS)
+          + (f"  (speed-up {wall['spectrum'] / wall['abstract']:.2f}x when nothing was cached)"
+             if wall.get("abstract", 0) > 0 else ""))
+    print(f"{len(rows) - bad}/{len(rows)} points within tolerance (thr {100 * args.tol_thr:.1f}%, "
+          f"Jain {args.tol_jain}); wrote {out}")
+    return 1 if bad else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())